@@ -17,7 +17,8 @@ ESP32_AsyncWebController::ESP32_AsyncWebController(uint16_t port, uint8_t maxCha
     , _maxChannels(maxChannels)
     , _systemName("ESP32 Controller")
     , _corsEnabled(false)
-    , _controlCallback(nullptr)
+    , _autoBroadcast(true)
+    , _controlHandler(nullptr)
     , _stateCallback(nullptr)
     , _allStatesCallback(nullptr)
     , _htmlCallback(nullptr)
@@ -99,11 +100,23 @@ void ESP32_AsyncWebController::setCallbacks(
     OutputStateCallback stateCallback,
     GetAllStatesCallback allStatesCallback
 ) {
-    _controlCallback = controlCallback;
+    // Plain callbacks cannot fail
+    if (controlCallback) {
+        _controlHandler = [controlCallback](uint8_t channel, bool state) {
+            controlCallback(channel, state);
+            return true;
+        };
+    } else {
+        _controlHandler = nullptr;
+    }
     _stateCallback = stateCallback;
     _allStatesCallback = allStatesCallback;
 }
 
+void ESP32_AsyncWebController::setControlHandler(OutputControlHandler controlHandler) {
+    _controlHandler = controlHandler;
+}
+
 void ESP32_AsyncWebController::setHTMLGenerator(GetHTMLCallback htmlCallback) {
     _htmlCallback = htmlCallback;
 }
@@ -116,6 +129,10 @@ void ESP32_AsyncWebController::enableCORS(bool enable) {
     _corsEnabled = enable;
 }
 
+void ESP32_AsyncWebController::setAutoBroadcast(bool enable) {
+    _autoBroadcast = enable;
+}
+
 // ============================================================
 // Server Start
 // ============================================================
@@ -232,9 +249,13 @@ void ESP32_AsyncWebController::handleWebSocketEvent(
         uint8_t channel = doc["channel"];
         bool state = doc["state"];
         
-        if (isChannelValid(channel) && _controlCallback) {
-          _controlCallback(channel, state);
-          broadcastStateChange(channel, state);
+        if (isChannelValid(channel) && _controlHandler) {
+          if (!_controlHandler(channel, state)) {
+            // Nur der anfragende Client erfährt vom Fehler
+            client->text("{\"error\":\"Output not set\",\"channel\":" + String(channel) + "}");
+          } else if (_autoBroadcast) {
+            broadcastStateChange(channel, state);
+          }
         }
       }
     }
@@ -299,13 +320,18 @@ void ESP32_AsyncWebController::handleSetOutput(AsyncWebServerRequest* request) {
     return;
   }
   
-  if (!_controlCallback) {
+  if (!_controlHandler) {
     request->send(500, "application/json", "{\"error\":\"Control callback not set\"}");
     return;
   }
   
-  _controlCallback(channel, state);
-  broadcastStateChange(channel, state);
+  if (!_controlHandler(channel, state)) {
+    request->send(503, "application/json", "{\"error\":\"Output not set\"}");
+    return;
+  }
+  if (_autoBroadcast) {
+    broadcastStateChange(channel, state);
+  }
   
   JsonDocument doc;
   doc["success"] = true;
@@ -350,6 +376,14 @@ void ESP32_AsyncWebController::broadcastStateChange(uint8_t channel, bool state)
   _ws->textAll(message);
 }
 
+void ESP32_AsyncWebController::broadcastAllStates() {
+  if (!_allStatesCallback) {
+    return;
+  }
+  
+  _ws->textAll(_allStatesCallback());
+}
+
 void ESP32_AsyncWebController::addRoute(const char* uri, WebRequestMethod method, ArRequestHandlerFunction handler) {
   _server->on(uri, method, handler);
 }
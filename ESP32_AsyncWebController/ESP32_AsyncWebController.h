@@ -52,6 +52,14 @@
  */
 using OutputControlCallback = std::function<void(uint8_t channel, bool state)>;
 
+/**
+ * @brief Handler to control an output channel, with result
+ * @param channel Channel number (0-based)
+ * @param state Desired state (true = ON, false = OFF)
+ * @return false if the output could not be set (answered with an error)
+ */
+using OutputControlHandler = std::function<bool(uint8_t channel, bool state)>;
+
 /**
  * @brief Callback to read single channel state
  * @param channel Channel number (0-based)
@@ -154,6 +162,15 @@ public:
         GetAllStatesCallback allStatesCallback
     );
     
+    /**
+     * @brief Set output control handler with result
+     * @param controlHandler Handler to set output state
+     * @note Replaces the control callback of setCallbacks(). When the
+     *       handler returns false, HTTP requests get 503 and WebSocket
+     *       clients an error message; nothing is broadcast.
+     */
+    void setControlHandler(OutputControlHandler controlHandler);
+    
     /**
      * @brief Set HTML generator callback
      * @param htmlCallback Function returning HTML string
@@ -175,6 +192,14 @@ public:
      */
     void enableCORS(bool enable = true);
     
+    /**
+     * @brief Broadcast changes made via HTTP/WebSocket automatically
+     * @param enable true (default) to broadcast after each control call
+     * @note Disable when the application broadcasts itself, e.g. from a
+     *       state observer, or every change is sent twice.
+     */
+    void setAutoBroadcast(bool enable);
+    
     /**
      * @brief Start the webserver
      */
@@ -195,6 +220,14 @@ public:
      */
     void broadcastStateChange(uint8_t channel, bool state);
     
+    /**
+     * @brief Broadcast all channel states to all WebSocket clients
+     * 
+     * Sends the JSON of the all-states callback as one message, e.g.
+     * from a state observer after a batch changed several channels.
+     */
+    void broadcastAllStates();
+    
     // ========== Custom Routes ==========
     
     /**
@@ -221,9 +254,10 @@ private:
     uint8_t _maxChannels;
     String _systemName;
     bool _corsEnabled;
+    bool _autoBroadcast;
     
     // Callbacks
-    OutputControlCallback _controlCallback;
+    OutputControlHandler _controlHandler;
     OutputStateCallback _stateCallback;
     GetAllStatesCallback _allStatesCallback;
     GetHTMLCallback _htmlCallback;
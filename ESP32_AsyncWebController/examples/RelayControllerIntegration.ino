@@ -7,6 +7,7 @@
  */
 
 #include <Arduino.h>
+#include <atomic>
 #include <LatchController.h>
 #include <drivers/ShiftRegisterDriver.h>
 #include <ESP32_AsyncWebController.h>
@@ -32,42 +33,50 @@ ShiftRegisterDriver relayDriver(PIN_DATA, PIN_CLOCK, PIN_LATCH);
 LatchController relays(&relayDriver, 8);
 ESP32_AsyncWebController webServer(80, 8);
 
-// Thread-Safety für Multi-Core
-SemaphoreHandle_t relayMutex;
-
 // ============================================================
 // Callbacks
 // ============================================================
+// Schreibzugriffe gehen als Kommando an den Owner-Task (Core 1).
+// Der Web-Task blockiert dadurch nie auf den Shift-Vorgang.
+// false (Queue voll) beantwortet der Webserver mit einem Fehler.
 
-void setRelay(uint8_t channel, bool state) {
-  if (xSemaphoreTake(relayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-    state ? relays.setLatchOn(channel) : relays.setLatchOff(channel);
-    xSemaphoreGive(relayMutex);
-  }
+bool setRelay(uint8_t channel, bool state) {
+  return relays.postLatch(channel, state);
 }
 
+// Lesezugriffe über den lock-freien Snapshot: kein Mutex, der
+// Web-Task wartet nie auf den Owner-Task
+
 bool getRelay(uint8_t channel) {
-  bool state = false;
-  if (xSemaphoreTake(relayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-    state = relays.getLatchState(channel);
-    xSemaphoreGive(relayMutex);
-  }
-  return state;
+  LatchSnapshot snap;
+  relays.getSnapshot(snap);
+  return snap.mask.get(channel);
 }
 
 String getAllRelays() {
+  LatchSnapshot snap;
+  relays.getSnapshot(snap);
+  
   String json = "{\"channels\":{";
-  if (xSemaphoreTake(relayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-    for (int i = 0; i < 8; i++) {
-      json += "\"" + String(i) + "\":" + (relays.getLatchState(i) ? "true" : "false");
-      if (i < 7) json += ",";
-    }
-    xSemaphoreGive(relayMutex);
+  for (int i = 0; i < 8; i++) {
+    json += "\"" + String(i) + "\":" + (snap.mask.get(i) ? "true" : "false");
+    if (i < 7) json += ",";
   }
   json += "}}";
   return json;
 }
 
+// Jede Hardware-Änderung (auch von anderen Tasks oder Timern) wird
+// als eine Nachricht an alle Browser gepusht - einmal pro Batch.
+// Deshalb ist der automatische Broadcast des Webservers abgeschaltet.
+// Der Observer läuft ggf. im esp_timer-Task (zeitgesteuerte Rückfälle,
+// Sequencer): er setzt nur ein Flag, gesendet wird im Web-Task.
+std::atomic<bool> relaysChanged(false);
+
+void onRelaysChanged(const LatchChange& /*change*/, void* /*context*/) {
+  relaysChanged = true;
+}
+
 // ============================================================
 // Tasks
 // ============================================================
@@ -75,39 +84,30 @@ String getAllRelays() {
 void webServerTask(void* param) {
   webServer.startAP(AP_SSID, AP_PASSWORD);
   webServer.setSystemName("8-Channel Relay Controller");
-  webServer.setCallbacks(setRelay, getRelay, getAllRelays);
+  webServer.setCallbacks(nullptr, getRelay, getAllRelays);
+  webServer.setControlHandler(setRelay);
+  webServer.setAutoBroadcast(false);   // sendet onRelaysChanged()
   
   // Custom Route: Alle Relais ausschalten
   webServer.addRoute("/api/alloff", HTTP_POST, [](AsyncWebServerRequest* req) {
-    if (xSemaphoreTake(relayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-      relays.setAllOff();
-      xSemaphoreGive(relayMutex);
+    if (relays.postAllLatches(0)) {
       req->send(200, "application/json", "{\"success\":true}");
     } else {
-      req->send(500, "application/json", "{\"success\":false}");
+      req->send(503, "application/json", "{\"success\":false}");
     }
   });
   
   webServer.begin();
   
   for (;;) {
+    if (relaysChanged.exchange(false)) {
+      webServer.broadcastAllStates();
+    }
     webServer.loop();
     vTaskDelay(pdMS_TO_TICKS(10));
   }
 }
 
-void relayTask(void* param) {
-  if (xSemaphoreTake(relayMutex, portMAX_DELAY) == pdTRUE) {
-    relays.begin(ACTIVE_LOW);
-    relays.setAllOff();
-    xSemaphoreGive(relayMutex);
-  }
-  
-  for (;;) {
-    vTaskDelay(pdMS_TO_TICKS(1000));
-  }
-}
-
 // ============================================================
 // Setup
 // ============================================================
@@ -116,9 +116,13 @@ void setup() {
   Serial.begin(115200);
   delay(1000);
   
-  relayMutex = xSemaphoreCreateMutex();
+  relays.begin(ACTIVE_LOW);
+  relays.setAllOff();
+  relays.subscribe(onRelaysChanged);
+  
+  // Owner-Task auf Core 1 übernimmt den Shift-Register-Zugriff
+  relays.startOwnerTask(1);
   
-  xTaskCreatePinnedToCore(relayTask, "Relay", 4096, NULL, 1, NULL, 1);
   xTaskCreatePinnedToCore(webServerTask, "Web", 8192, NULL, 2, NULL, 0);
   
   Serial.println("System started!");
@@ -0,0 +1,271 @@
+/**
+ * @file LatchCommandQueue.h
+ * @brief Lock-free command queue for the LatchController owner task
+ * @version 3.0.0
+ * @author MROutake
+ *
+ * Bounded multi-producer / single-consumer ring buffer. Producers
+ * (web server, MQTT, application tasks) never block: a full queue is
+ * reported to the caller instead. Only the owner task consumes.
+ */
+
+#ifndef LATCH_COMMAND_QUEUE_H
+#define LATCH_COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <new>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// ============================================================
+// LatchCompletion
+// ============================================================
+
+/**
+ * @class LatchCompletion
+ * @brief Optional completion handle for posted commands
+ *
+ * Owned by the caller and must stay valid until the command completes.
+ * A command completes after its hardware update has been issued. With
+ * asynchronous drivers (supportsAsync()) that means "submitted to the
+ * bus", not "on the pins": use LatchController::isTransferBusy() or
+ * flush the driver when the physical outputs matter.
+ *
+ * Each handle has its own binary semaphore, so waiting never consumes
+ * task notifications of the calling task.
+ *
+ * @note Never wait() from the owner task: it would wait for itself.
+ */
+class LatchCompletion {
+private:
+    StaticSemaphore_t signalBuffer;
+    SemaphoreHandle_t signal;
+    std::atomic<bool> done;
+    std::atomic<TaskHandle_t> owner;   ///< Task executing the command
+    bool success;
+
+    friend class LatchController;
+
+    /**
+     * @brief Remember the task that will complete the handle (post())
+     * @param task Owner task, nullptr if executed by the caller
+     */
+    void setOwner(TaskHandle_t task) {
+        owner.store(task);
+    }
+
+public:
+    LatchCompletion() : done(false), owner(nullptr), success(false) {
+        signal = xSemaphoreCreateBinaryStatic(&signalBuffer);
+    }
+
+    ~LatchCompletion() {
+        vSemaphoreDelete(signal);
+    }
+
+    LatchCompletion(const LatchCompletion&) = delete;
+    LatchCompletion& operator=(const LatchCompletion&) = delete;
+
+    /**
+     * @brief Reset the handle for reuse
+     */
+    void reset() {
+        success = false;
+        owner.store(nullptr);
+        done.store(false);
+        // Drop a signal nobody waited for
+        xSemaphoreTake(signal, 0);
+    }
+
+    /**
+     * @brief Check if the command has been executed
+     * @return true once the owner task has processed the command
+     */
+    bool isDone() const {
+        return done.load();
+    }
+
+    /**
+     * @brief Get command result
+     * @return true if the command was valid and applied
+     */
+    bool result() const {
+        return success;
+    }
+
+    /**
+     * @brief Block until the command has been executed
+     * @param timeout Maximum wait time in ticks
+     * @return true if completed within the timeout, false on timeout
+     *         or when called from the owner task
+     */
+    bool wait(TickType_t timeout = portMAX_DELAY) {
+        TaskHandle_t task = owner.load();
+        bool self = (task != nullptr && task == xTaskGetCurrentTaskHandle());
+        configASSERT(!self);
+        if (self) {
+            return false;
+        }
+        if (done.load()) {
+            return true;
+        }
+        if (xSemaphoreTake(signal, timeout) != pdTRUE) {
+            return done.load();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Mark as completed (called by the owner task)
+     * @param ok Command result
+     */
+    void complete(bool ok) {
+        success = ok;
+        done.store(true);
+        xSemaphoreGive(signal);
+    }
+};
+
+// ============================================================
+// LatchCommand
+// ============================================================
+
+/**
+ * @enum LatchCommandType
+ * @brief Operation carried by a LatchCommand
+ */
+enum LatchCommandType {
+    LATCH_CMD_SET,        ///< Set channel to state
+    LATCH_CMD_TOGGLE,     ///< Toggle channel
+    LATCH_CMD_SET_ALL,    ///< Set channels 0-31 from mask, others OFF
+    LATCH_CMD_REFRESH,    ///< Rewrite hardware
+    LATCH_CMD_SET_FOR     ///< Set channel to state for 'mask' milliseconds
+};
+
+/**
+ * @struct LatchCommand
+ * @brief Single queued controller operation
+ */
+struct LatchCommand {
+    LatchCommandType type;
+    uint16_t channel;
+    bool state;
+    uint32_t mask;
+    LatchCompletion* completion;   ///< Optional, may be nullptr
+};
+
+// ============================================================
+// LatchCommandQueue
+// ============================================================
+
+/**
+ * @class LatchCommandQueue
+ * @brief Bounded lock-free MPSC queue of LatchCommand
+ *
+ * Each slot carries a sequence number telling producers and the
+ * consumer whether it is free or filled, so push() only needs a single
+ * compare-and-swap on the write position.
+ */
+class LatchCommandQueue {
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        LatchCommand command;
+    };
+
+    Slot* slots;
+    uint32_t mask;
+    std::atomic<uint32_t> writePos;
+    uint32_t readPos;
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Number of slots, rounded up to a power of two
+     */
+    explicit LatchCommandQueue(uint16_t capacity) : writePos(0), readPos(0) {
+        uint32_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        slots = new (std::nothrow) Slot[size];
+        if (slots == nullptr) {
+            return;
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~LatchCommandQueue() {
+        delete[] slots;
+    }
+
+    /**
+     * @brief Check if the slot array could be allocated
+     * @return false if out of memory (queue unusable)
+     */
+    bool isValid() const {
+        return slots != nullptr;
+    }
+
+    LatchCommandQueue(const LatchCommandQueue&) = delete;
+    LatchCommandQueue& operator=(const LatchCommandQueue&) = delete;
+
+    /**
+     * @brief Enqueue a command (any task, never blocks)
+     * @param command Command to copy into the queue
+     * @return false if the queue is full
+     */
+    bool push(const LatchCommand& command) {
+        uint32_t pos = writePos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & mask];
+            uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - pos);
+            if (diff == 0) {
+                if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // Full
+            } else {
+                pos = writePos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->command = command;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeue a command (owner task only)
+     * @param command Destination
+     * @return false if the queue is empty
+     */
+    bool pop(LatchCommand& command) {
+        Slot* slot = &slots[readPos & mask];
+        uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+        if ((int32_t)(seq - (readPos + 1)) < 0) {
+            return false;   // Empty (or producer still writing)
+        }
+        command = slot->command;
+        slot->sequence.store(readPos + mask + 1, std::memory_order_release);
+        readPos++;
+        return true;
+    }
+
+    /**
+     * @brief Get queue capacity
+     * @return Number of slots
+     */
+    uint32_t capacity() const {
+        return mask + 1;
+    }
+};
+
+#endif // LATCH_COMMAND_QUEUE_H
@@ -5,26 +5,115 @@
  */
 
 #include "LatchController.h"
+#include <new>
 
 // ============================================================
 // LatchController Implementation
 // ============================================================
 
-LatchController::LatchController(LatchDriver* drv, uint8_t channels) 
+LatchController::LatchController(LatchDriver* drv, uint16_t channels) 
     : driver(drv)
-    , channelCount(min(channels, (uint8_t)32))  // Max 32 channels
-    , currentState(0)
+    , channelCount(min(channels, (uint16_t)LATCH_MAX_CHANNELS))
     , triggerMode(ACTIVE_HIGH)
     , initialized(false)
     , lock(nullptr)
+    , batchDepth(0)
+    , batchDirty(false)
+    , outputValid(false)
+    , hardwareWrites(0)
+    , suppressedWrites(0)
+    , brightness(255)
+    , partialUpdates(false)
+    , asyncTransfers(false)
+    , transferBusy(false)
+    , transferPending(false)
+    , transferFailed(false)
+    , pumpTask(nullptr)
+    , commandQueue(nullptr)
+    , ownerTask(nullptr)
+    , ownerStop(false)
+    , ownerAccepting(false)
+    , ownerPosts(0)
+    , droppedCommands(0)
+    , serviceTimer(nullptr)
+    , serviceDue(0)
+    , flushIntervalUs(0)
+    , flushPending(false)
+    , lastFlushUs(0)
+    , protection(nullptr)
+    , deferredSwitches(0)
+    , rejectedSwitches(0)
+    , staggerSize(0)
+    , staggerIntervalUs(0)
+    , staggerStepUs(0)
+    , staggerCount(0)
+    , lockDepth(0)
+    , changePending(false)
+    , changeSequence(0)
+    , snapshotSeq(0)
+    , remapTable(nullptr)
+    , remapNibbles(0)
 {
+    currentState.clear();
+    appliedState.clear();
+    deferred.clear();
+    outputMask.fill(LATCH_MAX_CHANNELS);
+    timedActive.clear();
+    timedRevert.clear();
+    for (uint16_t i = 0; i < LATCH_MAX_CHANNELS; i++) {
+        timedUntil[i] = 0;
+    }
+    for (uint8_t i = 0; i < LATCH_MAX_OBSERVERS; i++) {
+        observers[i].callback = nullptr;
+        observers[i].context = nullptr;
+        observerCalls[i].store(0);
+    }
+    publishedState.clear();
+    snapshot.mask.clear();
+    snapshot.sequence = 0;
+    snapshot.timestampUs = 0;
+    portMUX_INITIALIZE(&snapshotMux);
+    polarityOverride.clear();
+    polarityLow.clear();
+    outputInvert.clear();
+    powerOnState.clear();
+    lastOutput.clear();
+    pendingOutput.clear();
+    portMUX_INITIALIZE(&asyncMux);
 }
 
 LatchController::~LatchController() {
+    stopOwnerTask();
+    if (serviceTimer != nullptr) {
+        esp_timer_stop(serviceTimer);
+        esp_timer_delete(serviceTimer);
+        serviceTimer = nullptr;
+    }
+    if (pumpTask != nullptr) {
+        // Let the pipeline drain first: only completions clear
+        // transferBusy, so the callback stays attached while waiting
+        // (bounded, in case the hardware never completes)
+        for (uint8_t i = 0; i < 100 && isTransferBusy(); i++) {
+            vTaskDelay(1);
+        }
+        if (isTransferBusy()) {
+            Serial.println("[LatchController] ERROR: Transfer still busy at destruction!");
+        }
+    }
+    // No completion can reach the pump task after this point
+    if (driver != nullptr) {
+        driver->setTransferCallback(nullptr, nullptr);
+    }
+    if (pumpTask != nullptr) {
+        vTaskDelete(pumpTask);
+        pumpTask = nullptr;
+    }
     if (lock != nullptr) {
         vSemaphoreDelete(lock);
         lock = nullptr;
     }
+    delete[] protection;
+    delete[] remapTable;
 }
 
 bool LatchController::begin(LatchTriggerMode mode) {
@@ -34,9 +123,9 @@ bool LatchController::begin(LatchTriggerMode mode) {
         return false;
     }
 
-    // Create mutex if not exists
+    // Create mutex if not exists (recursive: batches re-enter the lock)
     if (lock == nullptr) {
-        lock = xSemaphoreCreateMutex();
+        lock = xSemaphoreCreateRecursiveMutex();
         if (lock == nullptr) {
             Serial.println("[LatchController] ERROR: Failed to create mutex!");
             return false;
@@ -44,6 +133,7 @@ bool LatchController::begin(LatchTriggerMode mode) {
     }
 
     triggerMode = mode;
+    updateOutputInvert();
 
     // Initialize driver
     if (!driver->init()) {
@@ -51,10 +141,56 @@ bool LatchController::begin(LatchTriggerMode mode) {
         return false;
     }
 
-    // Set all outputs OFF (considering trigger mode)
-    currentState = 0;
-    uint32_t outputData = (triggerMode == ACTIVE_LOW) ? ~currentState : currentState;
-    driver->updateHardware(outputData, channelCount);
+    partialUpdates = driver->supportsPartialUpdate();
+    asyncTransfers = driver->supportsAsync();
+    if (driver->supportsBrightness()) {
+        driver->setBrightness(brightness);
+    }
+
+    // Async drivers: completion may arrive in ISR context, a small
+    // pump task submits the newest coalesced output afterwards
+    if (asyncTransfers && pumpTask == nullptr) {
+        driver->setTransferCallback(transferCompleteEntry, this);
+        if (xTaskCreatePinnedToCore(pumpTaskEntry, "LatchPump", 2048, this,
+                                    configMAX_PRIORITIES - 2, &pumpTask, tskNO_AFFINITY) != pdPASS) {
+            Serial.println("[LatchController] ERROR: Failed to create pump task!");
+            pumpTask = nullptr;
+            return false;
+        }
+    }
+
+    // Single timer for all deferred work of this controller
+    if (serviceTimer == nullptr) {
+        esp_timer_create_args_t args = {};
+        args.callback = serviceTimerEntry;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "LatchService";
+        if (esp_timer_create(&args, &serviceTimer) != ESP_OK) {
+            Serial.println("[LatchController] ERROR: Failed to create service timer!");
+            serviceTimer = nullptr;
+            return false;
+        }
+    }
+
+    // First write shows the power-on state (default: all OFF)
+    currentState = powerOnState;
+    currentState.limit(channelCount);
+    appliedState = currentState;
+    deferred.clear();
+    timedActive.clear();
+    hardwareWrites = 0;
+    suppressedWrites = 0;
+    deferredSwitches = 0;
+    rejectedSwitches = 0;
+
+    // The power-on state is the baseline, not a change: observers and
+    // the snapshot start from it instead of an all-OFF state
+    publishedState = appliedState;
+    changePending = false;
+    publishSnapshot(esp_timer_get_time());
+
+    writeHardware(true);
 
     initialized = true;
 
@@ -66,19 +202,272 @@ bool LatchController::begin(LatchTriggerMode mode) {
     return true;
 }
 
+void LatchController::setPowerOnState(const uint32_t* words, uint8_t wordCount) {
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        powerOnState.words[w] = (w < wordCount) ? words[w] : 0;
+    }
+}
+
 void LatchController::takeLock() {
     if (lock != nullptr) {
-        xSemaphoreTake(lock, portMAX_DELAY);
+        xSemaphoreTakeRecursive(lock, portMAX_DELAY);
     }
+    lockDepth++;
+}
+
+bool LatchController::tryTakeLock() {
+    if (lock != nullptr && xSemaphoreTakeRecursive(lock, 0) != pdTRUE) {
+        return false;
+    }
+    lockDepth++;
+    return true;
 }
 
 void LatchController::giveLock() {
+    // Leaving the outermost level: take the pending change and the
+    // observer list along, notify after the mutex has been released
+    bool notify = (lockDepth == 1 && changePending);
+    LatchChange change;
+    ObserverSlot targets[LATCH_MAX_OBSERVERS];
+    if (notify) {
+        change = pendingChange;
+        changePending = false;
+        for (uint8_t i = 0; i < LATCH_MAX_OBSERVERS; i++) {
+            targets[i] = observers[i];
+            // Counted under the lock: unsubscribe() waits for it
+            if (targets[i].callback != nullptr) {
+                observerCalls[i]++;
+            }
+        }
+    }
+
+    lockDepth--;
     if (lock != nullptr) {
-        xSemaphoreGive(lock);
+        xSemaphoreGiveRecursive(lock);
+    }
+
+    if (notify) {
+        for (uint8_t i = 0; i < LATCH_MAX_OBSERVERS; i++) {
+            if (targets[i].callback != nullptr) {
+                targets[i].callback(change, targets[i].context);
+                observerCalls[i]--;
+            }
+        }
+    }
+}
+
+void LatchController::commitLocked() {
+    // Inside a batch: only remember that a flush is due
+    if (batchDepth > 0) {
+        batchDirty = true;
+        return;
+    }
+
+    updateApplied();
+
+    // Coalescing window: write at once after a quiet period, otherwise
+    // let the service timer flush the newest state when it closes
+    if (flushIntervalUs > 0) {
+        int64_t due = lastFlushUs + flushIntervalUs;
+        if (esp_timer_get_time() < due) {
+            flushPending = true;
+            scheduleService(due);
+            return;
+        }
+    }
+    writeHardware();
+}
+
+void LatchController::writeHardware(bool force) {
+    // Apply output mask, channel map and hardware inversion
+    LatchState visible;
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        visible.words[w] = appliedState.words[w] & outputMask.words[w];
+    }
+    LatchState outputData;
+    remapOutput(visible, outputData);
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        outputData.words[w] ^= outputInvert.words[w];
+    }
+    recordChange();
+
+    flushPending = false;
+
+    if (asyncTransfers) {
+        // A failed submit from the pump task left the hardware behind
+        portENTER_CRITICAL(&asyncMux);
+        if (transferFailed) {
+            transferFailed = false;
+            outputValid = false;
+        }
+        portEXIT_CRITICAL(&asyncMux);
+    }
+
+    // Skip the bus transfer if the hardware already shows this pattern
+    if (!force && outputValid && outputData == lastOutput) {
+        suppressedWrites++;
+        return;
+    }
+
+    if (asyncTransfers) {
+        // Counted when handed to the driver, here or by the pump task
+        if (!submitOutput(outputData)) {
+            outputValid = false;
+            return;
+        }
+    } else if (partialUpdates && outputValid && !force) {
+        // Hand the XOR of old and new output to the driver
+        LatchState changed;
+        for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+            changed.words[w] = outputData.words[w] ^ lastOutput.words[w];
+        }
+        driver->updateChannels(outputData.words, changed.words, channelCount);
+        hardwareWrites++;
+    } else {
+        driver->updateHardwareWords(outputData.words, channelCount);
+        hardwareWrites++;
+    }
+    lastOutput = outputData;
+    outputValid = true;
+    lastFlushUs = esp_timer_get_time();
+}
+
+// ============================================================
+// Asynchronous Transfers
+// ============================================================
+
+void IRAM_ATTR LatchDriver::transferComplete() {
+    if (transferCallback != nullptr) {
+        transferCallback(transferContext);
+    }
+}
+
+bool LatchController::submitOutput(const LatchState& output) {
+    portENTER_CRITICAL(&asyncMux);
+    if (transferBusy) {
+        // Bus busy: keep only the newest output, the pump task submits it
+        if (transferPending) {
+            suppressedWrites++;
+        }
+        pendingOutput = output;
+        transferPending = true;
+        portEXIT_CRITICAL(&asyncMux);
+        return true;
+    }
+    transferBusy = true;
+    portEXIT_CRITICAL(&asyncMux);
+
+    if (!driver->submit(output.words, channelCount)) {
+        portENTER_CRITICAL(&asyncMux);
+        transferBusy = false;
+        portEXIT_CRITICAL(&asyncMux);
+        Serial.println("[LatchController] ERROR: Driver submit failed!");
+        return false;
     }
+    hardwareWrites++;
+    return true;
+}
+
+void IRAM_ATTR LatchController::transferCompleteEntry(void* context) {
+    static_cast<LatchController*>(context)->onTransferComplete();
 }
 
-bool LatchController::setLatch(uint8_t channel, bool state) {
+void IRAM_ATTR LatchController::onTransferComplete() {
+    portENTER_CRITICAL_ISR(&asyncMux);
+    bool next = transferPending;
+    if (!next) {
+        transferBusy = false;
+    }
+    portEXIT_CRITICAL_ISR(&asyncMux);
+
+    // Newer output waiting: let the pump task submit it (stays busy)
+    if (next && pumpTask != nullptr) {
+        if (xPortInIsrContext()) {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(pumpTask, &woken);
+            portYIELD_FROM_ISR(woken);
+        } else {
+            xTaskNotifyGive(pumpTask);
+        }
+    }
+}
+
+void LatchController::pumpTaskEntry(void* param) {
+    static_cast<LatchController*>(param)->pumpLoop();
+}
+
+void LatchController::pumpLoop() {
+    LatchState output;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        portENTER_CRITICAL(&asyncMux);
+        bool next = transferPending;
+        if (next) {
+            output = pendingOutput;
+            transferPending = false;
+        }
+        portEXIT_CRITICAL(&asyncMux);
+
+        if (!next) {
+            continue;
+        }
+        if (driver->submit(output.words, channelCount)) {
+            hardwareWrites++;
+        } else {
+            // Same as a failed direct submit: the next write must not
+            // be suppressed against an output that never arrived
+            portENTER_CRITICAL(&asyncMux);
+            transferBusy = false;
+            transferFailed = true;
+            portEXIT_CRITICAL(&asyncMux);
+            Serial.println("[LatchController] ERROR: Driver submit failed!");
+        }
+    }
+}
+
+bool LatchController::isTransferBusy() {
+    portENTER_CRITICAL(&asyncMux);
+    bool busy = transferBusy || transferPending;
+    portEXIT_CRITICAL(&asyncMux);
+    return busy;
+}
+
+void LatchController::beginBatch() {
+    takeLock();
+    batchDepth++;
+}
+
+bool LatchController::tryBeginBatch() {
+    if (!tryTakeLock()) {
+        return false;
+    }
+    batchDepth++;
+    return true;
+}
+
+void LatchController::commit() {
+    if (batchDepth == 0) {
+        Serial.println("[LatchController] ERROR: commit() without beginBatch()");
+        return;
+    }
+
+    batchDepth--;
+    if (batchDepth == 0 && batchDirty) {
+        batchDirty = false;
+        updateApplied();
+        writeHardware();
+    }
+
+    giveLock();
+}
+
+bool LatchController::isBatchActive() {
+    return batchDepth > 0;
+}
+
+bool LatchController::setLatch(uint16_t channel, bool state) {
     if (channel >= channelCount) {
         Serial.printf("[LatchController] ERROR: Invalid channel %d (max: %d)\n", 
                       channel, channelCount - 1);
@@ -87,36 +476,34 @@ bool LatchController::setLatch(uint8_t channel, bool state) {
 
     takeLock();
 
-    // Update internal logical state
-    if (state) {
-        currentState |= (1UL << channel);
-    } else {
-        currentState &= ~(1UL << channel);
-    }
+    // Update internal logical state (an explicit write wins over a timer)
+    currentState.set(channel, state);
+    timedActive.set(channel, false);
+
+    commitLocked();
 
-    // Apply hardware inversion for ACTIVE_LOW
-    uint32_t outputData = (triggerMode == ACTIVE_LOW) ? ~currentState : currentState;
-    driver->updateHardware(outputData, channelCount);
+    // Rejected by protection limits: state was restored
+    bool accepted = (currentState.get(channel) == state);
 
     giveLock();
-    return true;
+    return accepted;
 }
 
-bool LatchController::setLatchOn(uint8_t channel) {
+bool LatchController::setLatchOn(uint16_t channel) {
     // setLatchOn = Relais physisch AN schalten
     // Bei ACTIVE_LOW: Ausgang muss LOW sein → interner State = true (wird invertiert zu LOW)
     // Bei ACTIVE_HIGH: Ausgang muss HIGH sein → interner State = true
     return setLatch(channel, true);
 }
 
-bool LatchController::setLatchOff(uint8_t channel) {
+bool LatchController::setLatchOff(uint16_t channel) {
     // setLatchOff = Relais physisch AUS schalten
     // Bei ACTIVE_LOW: Ausgang muss HIGH sein → interner State = false (wird invertiert zu HIGH)
     // Bei ACTIVE_HIGH: Ausgang muss LOW sein → interner State = false
     return setLatch(channel, false);
 }
 
-bool LatchController::toggleLatch(uint8_t channel) {
+bool LatchController::toggleLatch(uint16_t channel) {
     if (channel >= channelCount) {
         Serial.printf("[LatchController] ERROR: Invalid channel %d\n", channel);
         return false;
@@ -124,31 +511,102 @@ bool LatchController::toggleLatch(uint8_t channel) {
 
     takeLock();
     
-    currentState ^= (1UL << channel);
+    bool state = !currentState.get(channel);
+    currentState.set(channel, state);
+    timedActive.set(channel, false);
     
-    uint32_t outputData = (triggerMode == ACTIVE_LOW) ? ~currentState : currentState;
-    driver->updateHardware(outputData, channelCount);
+    commitLocked();
+
+    bool accepted = (currentState.get(channel) == state);
     
     giveLock();
-    return true;
+    return accepted;
+}
+
+bool LatchController::setLatchFor(uint16_t channel, bool state, uint32_t durationMs) {
+    if (channel >= channelCount) {
+        Serial.printf("[LatchController] ERROR: Invalid channel %d\n", channel);
+        return false;
+    }
+    if (durationMs == 0) {
+        return setLatch(channel, state);
+    }
+
+    takeLock();
+
+    currentState.set(channel, state);
+    int64_t due = esp_timer_get_time() + (int64_t)durationMs * 1000;
+    timedUntil[channel] = due;
+    timedRevert.set(channel, !state);
+    timedActive.set(channel, true);
+
+    commitLocked();
+
+    bool accepted = (currentState.get(channel) == state);
+    if (accepted) {
+        scheduleService(due);
+    } else {
+        timedActive.set(channel, false);
+    }
+
+    giveLock();
+    return accepted;
+}
+
+bool LatchController::pulseLatch(uint16_t channel, uint32_t durationMs) {
+    return setLatchFor(channel, true, durationMs);
+}
+
+bool LatchController::cancelLatchTimer(uint16_t channel) {
+    if (channel >= channelCount) {
+        return false;
+    }
+
+    takeLock();
+    bool pending = timedActive.get(channel);
+    timedActive.set(channel, false);
+    giveLock();
+    return pending;
+}
+
+uint32_t LatchController::getLatchTimer(uint16_t channel) {
+    if (channel >= channelCount) {
+        return 0;
+    }
+
+    takeLock();
+    uint32_t remaining = 0;
+    if (timedActive.get(channel)) {
+        int64_t left = timedUntil[channel] - esp_timer_get_time();
+        remaining = (left > 0) ? (uint32_t)((left + 999) / 1000) : 0;
+    }
+    giveLock();
+    return remaining;
 }
 
 void LatchController::setAllLatches(uint32_t mask) {
+    setAllLatches(&mask, 1);
+}
+
+void LatchController::setAllLatches(const uint32_t* words, uint8_t wordCount) {
     takeLock();
     
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        currentState.words[w] = (w < wordCount) ? words[w] : 0;
+    }
     // Limit mask to valid channels
-    uint32_t channelMask = (1UL << channelCount) - 1;
-    currentState = mask & channelMask;
+    currentState.limit(channelCount);
+    timedActive.clear();
     
-    uint32_t outputData = (triggerMode == ACTIVE_LOW) ? ~currentState : currentState;
-    driver->updateHardware(outputData, channelCount);
+    commitLocked();
     
     giveLock();
 }
 
 void LatchController::setAllOn() {
-    uint32_t mask = (1UL << channelCount) - 1;
-    setAllLatches(mask);
+    LatchState mask;
+    mask.fill(channelCount);
+    setAllLatches(mask.words, LATCH_STATE_WORDS);
     Serial.println("[LatchController] All latches ON");
 }
 
@@ -157,31 +615,838 @@ void LatchController::setAllOff() {
     Serial.println("[LatchController] All latches OFF");
 }
 
-bool LatchController::getLatchState(uint8_t channel) {
+uint32_t LatchController::setBits(uint32_t mask) {
+    uint32_t previous;
+    modifyBits(&mask, &mask, 1, false, &previous);
+    return previous;
+}
+
+uint32_t LatchController::clearBits(uint32_t mask) {
+    uint32_t value = 0;
+    uint32_t previous;
+    modifyBits(&value, &mask, 1, false, &previous);
+    return previous;
+}
+
+uint32_t LatchController::toggleBits(uint32_t mask) {
+    uint32_t previous;
+    modifyBits(nullptr, &mask, 1, true, &previous);
+    return previous;
+}
+
+uint32_t LatchController::writeMasked(uint32_t value, uint32_t mask) {
+    uint32_t previous;
+    modifyBits(&value, &mask, 1, false, &previous);
+    return previous;
+}
+
+void LatchController::writeMasked(const uint32_t* value, const uint32_t* mask,
+                                  uint8_t wordCount, uint32_t* previous) {
+    modifyBits(value, mask, wordCount, false, previous);
+}
+
+void LatchController::toggleBits(const uint32_t* mask, uint8_t wordCount, uint32_t* previous) {
+    modifyBits(nullptr, mask, wordCount, true, previous);
+}
+
+void LatchController::modifyBits(const uint32_t* value, const uint32_t* mask, uint8_t wordCount,
+                                 bool toggle, uint32_t* previous) {
+    takeLock();
+
+    for (uint8_t w = 0; w < wordCount; w++) {
+        uint32_t current = (w < LATCH_STATE_WORDS) ? currentState.words[w] : 0;
+        if (previous != nullptr) {
+            previous[w] = current;
+        }
+        if (w >= LATCH_STATE_WORDS) {
+            continue;
+        }
+
+        uint32_t bits = mask[w] & LatchState::wordMask(w, channelCount);
+        currentState.words[w] = toggle ? (current ^ bits)
+                                       : ((current & ~bits) | (value[w] & bits));
+        // Explicit writes win over pending timed reverts
+        timedActive.words[w] &= ~bits;
+    }
+
+    commitLocked();
+
+    giveLock();
+}
+
+// ============================================================
+// Service Timer
+// ============================================================
+
+void LatchController::scheduleService(int64_t due) {
+    // Caller holds the lock; keep the earliest deadline
+    if (serviceTimer == nullptr || (serviceDue != 0 && serviceDue <= due)) {
+        return;
+    }
+    if (serviceDue != 0) {
+        esp_timer_stop(serviceTimer);
+    }
+    int64_t delay = due - esp_timer_get_time();
+    esp_timer_start_once(serviceTimer, delay > 0 ? delay : 1);
+    serviceDue = due;
+}
+
+void LatchController::serviceTimerEntry(void* arg) {
+    static_cast<LatchController*>(arg)->runService();
+}
+
+void LatchController::runService() {
+    // Runs in the esp_timer task: never wait for a lock holder, retry
+    // shortly instead (serviceDue stays set, the timer is armed again)
+    if (!tryTakeLock()) {
+        esp_timer_start_once(serviceTimer, LATCH_SERVICE_RETRY_US);
+        return;
+    }
+    serviceDue = 0;
+    int64_t now = esp_timer_get_time();
+
+    expireTimed(now);
+
+    // Deferred changes whose protection limits have passed
+    if (deferred.any() && batchDepth == 0) {
+        commitLocked();
+    }
+
+    if (flushPending && batchDepth == 0) {
+        int64_t due = lastFlushUs + flushIntervalUs;
+        if (now >= due) {
+            writeHardware();
+        } else {
+            scheduleService(due);
+        }
+    }
+
+    giveLock();
+}
+
+void LatchController::expireTimed(int64_t now) {
+    int64_t next = 0;
+    bool expired = false;
+
+    // All reverts due now share one hardware update
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        uint32_t pending = timedActive.words[w];
+        while (pending != 0) {
+            uint16_t channel = w * 32 + __builtin_ctz(pending);
+            pending &= pending - 1;
+
+            if (timedUntil[channel] <= now) {
+                currentState.set(channel, timedRevert.get(channel));
+                timedActive.set(channel, false);
+                expired = true;
+            } else if (next == 0 || timedUntil[channel] < next) {
+                next = timedUntil[channel];
+            }
+        }
+    }
+
+    if (expired) {
+        // Reverts are never rejected, only deferred by protection limits
+        updateApplied(false);
+        commitLocked();
+    }
+    if (next != 0) {
+        scheduleService(next);
+    }
+}
+
+// ============================================================
+// Write Coalescing
+// ============================================================
+
+void LatchController::setFlushInterval(uint32_t intervalUs) {
+    takeLock();
+    flushIntervalUs = intervalUs;
+    if (flushPending && batchDepth == 0) {
+        // Re-evaluate pending changes against the new window
+        commitLocked();
+    }
+    giveLock();
+}
+
+uint32_t LatchController::getFlushInterval() {
+    return flushIntervalUs;
+}
+
+void LatchController::flush() {
+    takeLock();
+    if (flushPending && batchDepth == 0) {
+        writeHardware();
+    }
+    giveLock();
+}
+
+// ============================================================
+// Relay Protection
+// ============================================================
+
+int64_t LatchController::switchAllowedAt(uint16_t channel, bool state) {
+    const ProtectionSlot& slot = protection[channel];
+    int64_t at = 0;
+
+    // Minimum dwell in the current state
+    if (slot.lastSwitchUs != 0) {
+        uint32_t dwellMs = state ? slot.config.minOffMs : slot.config.minOnMs;
+        at = slot.lastSwitchUs + (int64_t)dwellMs * 1000;
+    }
+
+    // Rate limit (GCRA): bursts of maxSwitches, then one per interval
+    if (slot.config.maxSwitches > 0) {
+        int64_t window = (int64_t)slot.config.rateWindowMs * 1000;
+        int64_t burst = window - window / slot.config.maxSwitches;
+        at = max(at, slot.rateTat - burst);
+    }
+    return at;
+}
+
+void LatchController::updateApplied(bool allowReject) {
+    if (protection == nullptr && staggerSize == 0) {
+        appliedState = currentState;
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    int64_t next = 0;
+
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        uint32_t diff = currentState.words[w] ^ appliedState.words[w];
+        while (diff != 0) {
+            uint16_t channel = w * 32 + __builtin_ctz(diff);
+            diff &= diff - 1;
+
+            bool state = currentState.get(channel);
+            int64_t allowedAt = (protection != nullptr) ? switchAllowedAt(channel, state) : 0;
+
+            if (allowedAt > now) {
+                if (allowReject && protection[channel].config.mode == LATCH_PROTECT_REJECT &&
+                    !deferred.get(channel)) {
+                    currentState.set(channel, !state);
+                    rejectedSwitches++;
+                    continue;
+                }
+                if (!deferred.get(channel)) {
+                    deferred.set(channel, true);
+                    deferredSwitches++;
+                }
+            } else if (state && staggerSize > 0) {
+                // Inrush staggering: limited switch-ons per step
+                if (now >= staggerStepUs + staggerIntervalUs) {
+                    staggerStepUs = now;
+                    staggerCount = 0;
+                }
+                if (staggerCount >= staggerSize) {
+                    allowedAt = staggerStepUs + staggerIntervalUs;
+                    deferred.set(channel, true);
+                } else {
+                    staggerCount++;
+                }
+            }
+
+            if (allowedAt > now) {
+                if (next == 0 || allowedAt < next) {
+                    next = allowedAt;
+                }
+                continue;
+            }
+
+            appliedState.set(channel, state);
+            deferred.set(channel, false);
+            if (protection != nullptr) {
+                ProtectionSlot& slot = protection[channel];
+                slot.lastSwitchUs = now;
+                if (slot.config.maxSwitches > 0) {
+                    int64_t interval = (int64_t)slot.config.rateWindowMs * 1000 / slot.config.maxSwitches;
+                    slot.rateTat = max(slot.rateTat, now) + interval;
+                }
+            }
+        }
+        // Deferred changes requested back in the meantime are dropped
+        deferred.words[w] &= currentState.words[w] ^ appliedState.words[w];
+    }
+
+    if (next != 0) {
+        scheduleService(next);
+    }
+}
+
+bool LatchController::setProtection(uint16_t channel, const LatchProtection& limits) {
+    if (channel >= channelCount) {
+        Serial.printf("[LatchController] ERROR: Invalid channel %d\n", channel);
+        return false;
+    }
+
+    takeLock();
+    if (protection == nullptr) {
+        protection = new (std::nothrow) ProtectionSlot[channelCount]();
+        if (protection == nullptr) {
+            giveLock();
+            Serial.println("[LatchController] ERROR: Out of memory for protection limits!");
+            return false;
+        }
+    }
+    protection[channel].config = limits;
+    giveLock();
+    return true;
+}
+
+bool LatchController::setProtection(const LatchProtection& limits) {
+    takeLock();
+    bool result = true;
+    for (uint16_t i = 0; i < channelCount && result; i++) {
+        result = setProtection(i, limits);
+    }
+    giveLock();
+    return result;
+}
+
+void LatchController::clearProtection() {
+    takeLock();
+    delete[] protection;
+    protection = nullptr;
+    deferred.clear();
+    commitLocked();
+    giveLock();
+}
+
+bool LatchController::isLatchPending(uint16_t channel) {
+    if (channel >= channelCount) {
+        return false;
+    }
+    return currentState.get(channel) != appliedState.get(channel);
+}
+
+uint32_t LatchController::getDeferredSwitches() {
+    return deferredSwitches;
+}
+
+uint32_t LatchController::getRejectedSwitches() {
+    return rejectedSwitches;
+}
+
+// ============================================================
+// Inrush Staggering
+// ============================================================
+
+void LatchController::setStagger(uint16_t channelsPerStep, uint32_t stepMs) {
+    takeLock();
+    staggerSize = channelsPerStep;
+    staggerIntervalUs = (int64_t)stepMs * 1000;
+    staggerStepUs = 0;
+    staggerCount = 0;
+    if (batchDepth == 0) {
+        // Disabling releases waiting switch-ons at once
+        commitLocked();
+    }
+    giveLock();
+}
+
+// ============================================================
+// Output Mask
+// ============================================================
+
+void LatchController::setOutputMask(const uint32_t* words, uint8_t wordCount) {
+    takeLock();
+
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        outputMask.words[w] = (w < wordCount) ? words[w] : 0;
+    }
+
+    commitLocked();
+
+    giveLock();
+}
+
+void LatchController::clearOutputMask() {
+    LatchState mask;
+    mask.fill(LATCH_MAX_CHANNELS);
+    setOutputMask(mask.words, LATCH_STATE_WORDS);
+}
+
+// ============================================================
+// Channel Mapping
+// ============================================================
+
+bool LatchController::setChannelMap(const uint16_t* physical, uint16_t count) {
+    if (physical == nullptr || count != channelCount) {
+        Serial.printf("[LatchController] ERROR: Channel map needs %d entries\n", channelCount);
+        return false;
+    }
+
+    // Must be a permutation: every output driven by exactly one channel
+    LatchState used;
+    used.clear();
+    for (uint16_t i = 0; i < count; i++) {
+        if (physical[i] >= channelCount || used.get(physical[i])) {
+            Serial.printf("[LatchController] ERROR: Invalid channel map entry %d\n", i);
+            return false;
+        }
+        used.set(physical[i], true);
+    }
+
+    // One table per input nibble: 16 entries of the physical words
+    // holding that nibble's bits. entry[v] = entry[v without its lowest
+    // bit] | output of the lowest bit.
+    uint8_t words = LATCH_WORD_COUNT(channelCount);
+    uint8_t nibbles = (channelCount + 3) / 4;
+    uint32_t* table = new (std::nothrow) uint32_t[(size_t)nibbles * 16 * words];
+    if (table == nullptr) {
+        Serial.println("[LatchController] ERROR: Out of memory for channel map!");
+        return false;
+    }
+
+    for (uint8_t n = 0; n < nibbles; n++) {
+        uint32_t* base = table + (size_t)n * 16 * words;
+        for (uint8_t w = 0; w < words; w++) {
+            base[w] = 0;
+        }
+        for (uint8_t v = 1; v < 16; v++) {
+            uint8_t bit = __builtin_ctz(v);
+            uint16_t channel = n * 4 + bit;
+            uint32_t* entry = base + v * words;
+            const uint32_t* rest = base + (v & (v - 1)) * words;
+            for (uint8_t w = 0; w < words; w++) {
+                entry[w] = rest[w];
+            }
+            if (channel < channelCount) {
+                uint16_t out = physical[channel];
+                entry[out >> 5] |= 1UL << (out & 31);
+            }
+        }
+    }
+
+    takeLock();
+    delete[] remapTable;
+    remapTable = table;
+    remapNibbles = nibbles;
+    updateOutputInvert();
+    commitLocked();
+    giveLock();
+    return true;
+}
+
+void LatchController::clearChannelMap() {
+    takeLock();
+    delete[] remapTable;
+    remapTable = nullptr;
+    remapNibbles = 0;
+    updateOutputInvert();
+    commitLocked();
+    giveLock();
+}
+
+bool LatchController::setChannelPolarity(uint16_t channel, LatchTriggerMode mode) {
+    if (channel >= channelCount) {
+        Serial.printf("[LatchController] ERROR: Invalid channel %d\n", channel);
+        return false;
+    }
+
+    takeLock();
+    polarityOverride.set(channel, true);
+    polarityLow.set(channel, mode == ACTIVE_LOW);
+    updateOutputInvert();
+    commitLocked();
+    giveLock();
+    return true;
+}
+
+void LatchController::clearChannelPolarity() {
+    takeLock();
+    polarityOverride.clear();
+    polarityLow.clear();
+    updateOutputInvert();
+    commitLocked();
+    giveLock();
+}
+
+void LatchController::remapOutput(const LatchState& logical, LatchState& physical) {
+    if (remapTable == nullptr) {
+        physical = logical;
+        return;
+    }
+
+    uint8_t words = LATCH_WORD_COUNT(channelCount);
+    physical.clear();
+    for (uint8_t n = 0; n < remapNibbles; n++) {
+        uint8_t value = (logical.words[n >> 3] >> ((n & 7) * 4)) & 0x0F;
+        if (value == 0) {
+            continue;
+        }
+        const uint32_t* entry = remapTable + ((size_t)n * 16 + value) * words;
+        for (uint8_t w = 0; w < words; w++) {
+            physical.words[w] |= entry[w];
+        }
+    }
+}
+
+void LatchController::updateOutputInvert() {
+    // Logical inversion per channel: global mode unless overridden
+    LatchState logical;
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        uint32_t global = (triggerMode == ACTIVE_LOW) ? 0xFFFFFFFFUL : 0;
+        logical.words[w] = (global & ~polarityOverride.words[w]) | polarityLow.words[w];
+    }
+    logical.limit(channelCount);
+
+    // Outputs beyond the channel count keep the global level
+    remapOutput(logical, outputInvert);
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        if (triggerMode == ACTIVE_LOW) {
+            outputInvert.words[w] |= ~LatchState::wordMask(w, channelCount);
+        }
+    }
+}
+
+// ============================================================
+// Brightness
+// ============================================================
+
+bool LatchController::setBrightness(uint8_t level) {
+    if (!initialized || !driver->supportsBrightness()) {
+        return false;
+    }
+
+    takeLock();
+    brightness = level;
+    driver->setBrightness(level);
+    giveLock();
+    return true;
+}
+
+uint8_t LatchController::getBrightness() {
+    return brightness;
+}
+
+// ============================================================
+// Change Notification
+// ============================================================
+
+void LatchController::recordChange() {
+    // Caller holds the lock. Output mask changes (dimming) are not
+    // state changes and never reach the observers.
+    if (appliedState == publishedState) {
+        return;
+    }
+
+    // Several writes under one lock (batch, service run) merge into
+    // one notification that still starts at the first old state
+    if (!changePending) {
+        pendingChange.oldMask = publishedState;
+        changePending = true;
+    }
+    pendingChange.newMask = appliedState;
+    for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+        pendingChange.changedMask.words[w] = pendingChange.oldMask.words[w] ^ appliedState.words[w];
+    }
+    pendingChange.sequence = ++changeSequence;
+    publishedState = appliedState;
+    publishSnapshot(esp_timer_get_time());
+}
+
+void LatchController::publishSnapshot(int64_t now) {
+    // Single writer (lock held). The critical section keeps a reader on
+    // this core from preempting the writer and spinning on an odd count.
+    portENTER_CRITICAL(&snapshotMux);
+    uint32_t seq = snapshotSeq.load(std::memory_order_relaxed);
+    snapshotSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    snapshot.mask = appliedState;
+    snapshot.sequence = changeSequence;
+    snapshot.timestampUs = now;
+
+    snapshotSeq.store(seq + 2, std::memory_order_release);
+    portEXIT_CRITICAL(&snapshotMux);
+}
+
+int8_t LatchController::subscribe(LatchObserver observer, void* context) {
+    if (observer == nullptr) {
+        return -1;
+    }
+
+    takeLock();
+    int8_t id = -1;
+    for (uint8_t i = 0; i < LATCH_MAX_OBSERVERS; i++) {
+        if (observers[i].callback == nullptr) {
+            observers[i].callback = observer;
+            observers[i].context = context;
+            id = i;
+            break;
+        }
+    }
+    giveLock();
+
+    if (id < 0) {
+        Serial.println("[LatchController] ERROR: No free observer slot!");
+    }
+    return id;
+}
+
+void LatchController::unsubscribe(int8_t id) {
+    if (id < 0 || id >= LATCH_MAX_OBSERVERS) {
+        return;
+    }
+
+    takeLock();
+    observers[id].callback = nullptr;
+    observers[id].context = nullptr;
+    giveLock();
+
+    // No new notification can start: wait for those still running
+    while (observerCalls[id].load() != 0) {
+        vTaskDelay(1);
+    }
+}
+
+// ============================================================
+// Owner Task
+// ============================================================
+
+bool LatchController::startOwnerTask(uint8_t core, UBaseType_t priority,
+                                     uint16_t queueSize, uint32_t stackSize) {
+    if (!initialized) {
+        Serial.println("[LatchController] ERROR: begin() must be called first!");
+        return false;
+    }
+    if (ownerTask != nullptr) {
+        return true;
+    }
+
+    commandQueue = new (std::nothrow) LatchCommandQueue(queueSize);
+    if (commandQueue == nullptr || !commandQueue->isValid()) {
+        Serial.println("[LatchController] ERROR: Out of memory for command queue!");
+        delete commandQueue;
+        commandQueue = nullptr;
+        return false;
+    }
+    ownerStop = false;
+
+    if (xTaskCreatePinnedToCore(ownerTaskEntry, "LatchOwner", stackSize, this,
+                                priority, &ownerTask, core) != pdPASS) {
+        Serial.println("[LatchController] ERROR: Failed to create owner task!");
+        ownerTask = nullptr;
+        delete commandQueue;
+        commandQueue = nullptr;
+        return false;
+    }
+    ownerAccepting = true;
+
+    Serial.printf("[LatchController] Owner task on core %d (queue: %u)\n",
+                  core, commandQueue->capacity());
+    return true;
+}
+
+void LatchController::stopOwnerTask() {
+    if (ownerTask == nullptr) {
+        return;
+    }
+    // The owner task would wait for itself to exit
+    bool self = (ownerTask == xTaskGetCurrentTaskHandle());
+    configASSERT(!self);
+    if (self) {
+        return;
+    }
+
+    // Close the gate, then wait for posts still pushing
+    ownerAccepting = false;
+    while (ownerPosts.load() != 0) {
+        vTaskDelay(1);
+    }
+
+    // Owner drains the queue, clears ownerTask and deletes itself
+    ownerStop = true;
+    xTaskNotifyGive(ownerTask);
+    while (ownerTask != nullptr) {
+        vTaskDelay(1);
+    }
+
+    // Nothing can be pushed anymore: fail what the owner did not see
+    LatchCommand command;
+    while (commandQueue->pop(command)) {
+        if (command.completion != nullptr) {
+            command.completion->complete(false);
+        }
+    }
+    delete commandQueue;
+    commandQueue = nullptr;
+}
+
+bool LatchController::hasOwnerTask() {
+    return ownerTask != nullptr;
+}
+
+void LatchController::ownerTaskEntry(void* param) {
+    static_cast<LatchController*>(param)->ownerLoop();
+}
+
+void LatchController::ownerLoop() {
+    const uint8_t MAX_PER_BATCH = 16;
+    LatchCompletion* completions[MAX_PER_BATCH];
+    bool results[MAX_PER_BATCH];
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Apply queued commands in batches, one hardware update each
+        bool more = true;
+        while (more) {
+            uint8_t count = 0;
+            uint8_t pending = 0;
+            LatchCommand command;
+
+            beginBatch();
+            while (count < MAX_PER_BATCH && (more = commandQueue->pop(command))) {
+                bool ok = executeCommand(command);
+                if (command.completion != nullptr) {
+                    completions[pending] = command.completion;
+                    results[pending++] = ok;
+                }
+                count++;
+            }
+            commit();
+
+            // Signal completions once the hardware shows the result
+            for (uint8_t i = 0; i < pending; i++) {
+                completions[i]->complete(results[i]);
+            }
+        }
+
+        if (ownerStop) {
+            ownerTask = nullptr;
+            vTaskDelete(nullptr);
+        }
+    }
+}
+
+bool LatchController::executeCommand(const LatchCommand& command) {
+    switch (command.type) {
+        case LATCH_CMD_SET:
+            return setLatch(command.channel, command.state);
+        case LATCH_CMD_TOGGLE:
+            return toggleLatch(command.channel);
+        case LATCH_CMD_SET_ALL:
+            setAllLatches(command.mask);
+            return true;
+        case LATCH_CMD_REFRESH:
+            refresh();
+            return true;
+        case LATCH_CMD_SET_FOR:
+            return setLatchFor(command.channel, command.state, command.mask);
+        default:
+            return false;
+    }
+}
+
+bool LatchController::post(const LatchCommand& command) {
+    // Gate: while counted in ownerPosts, stopOwnerTask() keeps the
+    // owner task and the queue alive
+    ownerPosts++;
+    TaskHandle_t owner = ownerTask;
+    if (!ownerAccepting.load() || owner == nullptr) {
+        ownerPosts--;
+        bool ok = executeCommand(command);
+        if (command.completion != nullptr) {
+            command.completion->complete(ok);
+        }
+        return true;
+    }
+
+    // Lets wait() detect a wait from the owner task itself
+    if (command.completion != nullptr) {
+        command.completion->setOwner(owner);
+    }
+    bool queued = commandQueue->push(command);
+    if (queued) {
+        xTaskNotifyGive(owner);
+    } else {
+        droppedCommands++;
+    }
+    ownerPosts--;
+    return queued;
+}
+
+bool LatchController::postLatch(uint16_t channel, bool state, LatchCompletion* completion) {
+    LatchCommand command = {LATCH_CMD_SET, channel, state, 0, completion};
+    return post(command);
+}
+
+bool LatchController::postToggle(uint16_t channel, LatchCompletion* completion) {
+    LatchCommand command = {LATCH_CMD_TOGGLE, channel, false, 0, completion};
+    return post(command);
+}
+
+bool LatchController::postLatchFor(uint16_t channel, bool state, uint32_t durationMs,
+                                   LatchCompletion* completion) {
+    LatchCommand command = {LATCH_CMD_SET_FOR, channel, state, durationMs, completion};
+    return post(command);
+}
+
+bool LatchController::postAllLatches(uint32_t mask, LatchCompletion* completion) {
+    LatchCommand command = {LATCH_CMD_SET_ALL, 0, false, mask, completion};
+    return post(command);
+}
+
+uint32_t LatchController::getDroppedCommands() {
+    return droppedCommands.load();
+}
+
+// ============================================================
+// State Query
+// ============================================================
+
+bool LatchController::getLatchState(uint16_t channel) {
     if (channel >= channelCount) {
         return false;
     }
     // Return logical state (not hardware state)
-    return (currentState & (1UL << channel)) != 0;
+    return currentState.get(channel);
 }
 
 uint32_t LatchController::getAllStates() {
-    return currentState;
+    return currentState.words[0];
 }
 
-uint8_t LatchController::getChannelCount() {
+void LatchController::getAllStates(uint32_t* words, uint8_t wordCount) {
+    for (uint8_t w = 0; w < wordCount; w++) {
+        words[w] = (w < LATCH_STATE_WORDS) ? currentState.words[w] : 0;
+    }
+}
+
+void LatchController::getSnapshot(LatchSnapshot& out) {
+    for (;;) {
+        uint32_t before = snapshotSeq.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;   // Writer active on the other core (a few cycles)
+        }
+        out = snapshot;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (snapshotSeq.load(std::memory_order_relaxed) == before) {
+            return;
+        }
+    }
+}
+
+uint16_t LatchController::getChannelCount() {
     return channelCount;
 }
 
+uint8_t LatchController::getWordCount() {
+    return LATCH_WORD_COUNT(channelCount);
+}
+
 void LatchController::setTriggerMode(LatchTriggerMode mode) {
     if (triggerMode != mode) {
         takeLock();
         
         triggerMode = mode;
+        updateOutputInvert();
         
         // Update hardware with new mode
-        uint32_t outputData = (triggerMode == ACTIVE_LOW) ? ~currentState : currentState;
-        driver->updateHardware(outputData, channelCount);
+        commitLocked();
         
         giveLock();
         
@@ -194,6 +1459,39 @@ bool LatchController::isInitialized() {
     return initialized;
 }
 
+void LatchController::refresh() {
+    if (!initialized) {
+        return;
+    }
+
+    takeLock();
+    if (batchDepth > 0) {
+        // Flush on commit, regardless of the dirty check
+        outputValid = false;
+        batchDirty = true;
+    } else {
+        writeHardware(true);
+    }
+    giveLock();
+}
+
+uint32_t LatchController::getHardwareWrites() {
+    return hardwareWrites.load();
+}
+
+uint32_t LatchController::getSuppressedWrites() {
+    return suppressedWrites;
+}
+
+void LatchController::resetStatistics() {
+    takeLock();
+    hardwareWrites = 0;
+    suppressedWrites = 0;
+    deferredSwitches = 0;
+    rejectedSwitches = 0;
+    giveLock();
+}
+
 void LatchController::printDebugInfo() {
     Serial.println();
     Serial.println("╔══════════════════════════════════════════╗");
@@ -204,12 +1502,26 @@ void LatchController::printDebugInfo() {
     Serial.printf("║ Channels:    %-26d ║\n", channelCount);
     Serial.printf("║ Mode:        %-26s ║\n", 
                   triggerMode == ACTIVE_HIGH ? "ACTIVE_HIGH" : "ACTIVE_LOW");
-    Serial.printf("║ State:       0x%08X                 ║\n", currentState);
+    for (uint8_t w = 0; w < getWordCount(); w++) {
+        Serial.printf("║ State[%2d]:   0x%08X                 ║\n", w, currentState.words[w]);
+    }
+    Serial.printf("║ HW writes:   %-26u ║\n", hardwareWrites.load());
+    Serial.printf("║ Suppressed:  %-26u ║\n", suppressedWrites);
+    if (protection != nullptr) {
+        Serial.printf("║ Deferred:    %-26u ║\n", deferredSwitches);
+        Serial.printf("║ Rejected:    %-26u ║\n", rejectedSwitches);
+    }
+    if (flushIntervalUs > 0) {
+        Serial.printf("║ Flush every: %-23u us ║\n", flushIntervalUs);
+    }
+    if (driver != nullptr && driver->supportsBrightness()) {
+        Serial.printf("║ Brightness:  %-26u ║\n", brightness);
+    }
     Serial.println("╠══════════════════════════════════════════╣");
     
-    for (uint8_t i = 0; i < channelCount; i++) {
+    for (uint16_t i = 0; i < channelCount; i++) {
         bool state = getLatchState(i);
-        Serial.printf("║ Channel %2d:  %s                       ║\n", 
+        Serial.printf("║ Channel %3d: %s                       ║\n", 
                       i, state ? "ON " : "OFF");
     }
     
@@ -17,7 +17,7 @@
  * Features:
  * - Thread-safe with FreeRTOS mutex
  * - Modular driver architecture
- * - Supports up to 32 channels
+ * - Up to 32 channels by default, more via LATCH_MAX_CHANNELS
  * - ACTIVE_HIGH / ACTIVE_LOW hardware support
  * 
  * FreeRTOS Best Practice:
@@ -31,15 +31,54 @@
 #include <Arduino.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include <atomic>
+#include "LatchCommandQueue.h"
 
 // ============================================================
 // Version
 // ============================================================
 #define LATCH_CONTROLLER_VERSION "3.0.0"
 
+// ============================================================
+// Capacity
+// ============================================================
+
+/**
+ * @brief Maximum channels per controller
+ * 
+ * State is stored as an array of 32-bit words sized by this value.
+ * Raise it for long shift register chains, e.g. in platformio.ini:
+ * @code
+ * build_flags = -DLATCH_MAX_CHANNELS=128
+ * @endcode
+ */
+#ifndef LATCH_MAX_CHANNELS
+#define LATCH_MAX_CHANNELS 32
+#endif
+
+/// Number of 32-bit words needed for a given channel count
+#define LATCH_WORD_COUNT(channels) (((channels) + 31) / 32)
+
+/// Number of 32-bit words in a LatchState
+#define LATCH_STATE_WORDS LATCH_WORD_COUNT(LATCH_MAX_CHANNELS)
+
+/// Timer retry delay in microseconds when a timer callback finds the lock busy
+#ifndef LATCH_SERVICE_RETRY_US
+#define LATCH_SERVICE_RETRY_US 1000
+#endif
+
 // Forward declaration
 class LatchDriver;
 
+/**
+ * @brief Completion callback for asynchronous driver transfers
+ * @param context Pointer registered with LatchDriver::setTransferCallback()
+ * @note May be invoked from ISR context
+ */
+typedef void (*LatchTransferCallback)(void* context);
+
 // ============================================================
 // Enums
 // ============================================================
@@ -53,6 +92,154 @@ enum LatchTriggerMode {
     ACTIVE_LOW    ///< Inverted logic: LOW = device active (typical for relay modules)
 };
 
+/**
+ * @enum LatchProtectionMode
+ * @brief What happens to a switch request that violates a protection limit
+ */
+enum LatchProtectionMode {
+    LATCH_PROTECT_DEFER,   ///< Apply as soon as allowed (requests coalesce)
+    LATCH_PROTECT_REJECT   ///< Drop the request and count it
+};
+
+/**
+ * @struct LatchProtection
+ * @brief Switching limits for one channel (relay contact protection)
+ */
+struct LatchProtection {
+    uint32_t minOnMs;        ///< Minimum ON time before switching OFF
+    uint32_t minOffMs;       ///< Minimum OFF time before switching ON
+    uint16_t maxSwitches;    ///< Switches allowed per rateWindowMs (0 = no rate limit)
+    uint32_t rateWindowMs;   ///< Rate limit window
+    LatchProtectionMode mode;
+};
+
+// ============================================================
+// LatchState
+// ============================================================
+
+/**
+ * @struct LatchState
+ * @brief Fixed-size bit array holding one bit per channel
+ * 
+ * Channel n is bit (n % 32) of words[n / 32].
+ */
+struct LatchState {
+    uint32_t words[LATCH_STATE_WORDS];
+
+    /// Clear all channels
+    void clear() {
+        for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+            words[w] = 0;
+        }
+    }
+
+    /// Set channels 0 to channels-1, clear the rest
+    void fill(uint16_t channels) {
+        for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+            words[w] = wordMask(w, channels);
+        }
+    }
+
+    /// Clear all bits at or above the given channel count
+    void limit(uint16_t channels) {
+        for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+            words[w] &= wordMask(w, channels);
+        }
+    }
+
+    /// Bits of word w that belong to the first 'channels' channels
+    static uint32_t wordMask(uint8_t w, uint16_t channels) {
+        if (channels >= (uint16_t)(w + 1) * 32) {
+            return 0xFFFFFFFFUL;
+        }
+        if (channels <= (uint16_t)w * 32) {
+            return 0;
+        }
+        return (1UL << (channels - w * 32)) - 1;
+    }
+
+    bool get(uint16_t channel) const {
+        return (words[channel >> 5] & (1UL << (channel & 31))) != 0;
+    }
+
+    void set(uint16_t channel, bool state) {
+        if (state) {
+            words[channel >> 5] |= (1UL << (channel & 31));
+        } else {
+            words[channel >> 5] &= ~(1UL << (channel & 31));
+        }
+    }
+
+    void toggle(uint16_t channel) {
+        words[channel >> 5] ^= (1UL << (channel & 31));
+    }
+
+    /// true if any channel is set
+    bool any() const {
+        for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+            if (words[w] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool operator==(const LatchState& other) const {
+        for (uint8_t w = 0; w < LATCH_STATE_WORDS; w++) {
+            if (words[w] != other.words[w]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const LatchState& other) const {
+        return !(*this == other);
+    }
+};
+
+// ============================================================
+// Change Notification
+// ============================================================
+
+/// Maximum observers per controller
+#ifndef LATCH_MAX_OBSERVERS
+#define LATCH_MAX_OBSERVERS 4
+#endif
+
+/**
+ * @struct LatchChange
+ * @brief One committed change of the applied (hardware) state
+ * 
+ * All changes committed while the controller lock was held, e.g. a
+ * whole batch, arrive as a single LatchChange.
+ */
+struct LatchChange {
+    LatchState oldMask;      ///< Logical state before the update
+    LatchState newMask;      ///< Logical state now driven to the hardware
+    LatchState changedMask;  ///< oldMask XOR newMask
+    uint32_t sequence;       ///< Increments with every committed change
+};
+
+/**
+ * @brief Observer for committed state changes
+ * @param change Old/new/changed state and sequence number
+ * @param context Pointer registered with LatchController::subscribe()
+ * @note Called outside the controller lock from the task that
+ *       committed the change; may call back into the controller.
+ */
+typedef void (*LatchObserver)(const LatchChange& change, void* context);
+
+/**
+ * @struct LatchSnapshot
+ * @brief Consistent copy of the applied state (see getSnapshot())
+ */
+struct LatchSnapshot {
+    LatchState mask;         ///< Logical state driven to the hardware
+    uint32_t sequence;       ///< Same numbering as LatchChange::sequence
+    int64_t timestampUs;     ///< esp_timer time of the change (0 = none yet)
+};
+
 // ============================================================
 // LatchController Class
 // ============================================================
@@ -69,23 +256,115 @@ enum LatchTriggerMode {
  */
 class LatchController {
 private:
+    /// Protection limits and switching history of one channel
+    struct ProtectionSlot {
+        LatchProtection config;
+        int64_t lastSwitchUs;   ///< Last applied change (0 = never)
+        int64_t rateTat;        ///< Rate limiter: theoretical arrival time
+    };
+
+    /// Registered observer (callback nullptr = free slot)
+    struct ObserverSlot {
+        LatchObserver callback;
+        void* context;
+    };
+
     LatchDriver* driver;
-    uint8_t channelCount;
-    uint32_t currentState;
+    uint16_t channelCount;
+    LatchState currentState; ///< Requested logical state
+    LatchState appliedState; ///< Logical state driven to the hardware
+    LatchState outputMask;   ///< Channels allowed to drive the hardware
     LatchTriggerMode triggerMode;
     bool initialized;
     SemaphoreHandle_t lock;
+    uint8_t batchDepth;      ///< Nesting level of beginBatch()/commit()
+    bool batchDirty;         ///< State changed while a batch was open
+    LatchState lastOutput;   ///< Last output written to the driver
+    bool outputValid;        ///< lastOutput reflects the hardware
+    std::atomic<uint32_t> hardwareWrites;   ///< Driver updates performed (pump task too)
+    uint32_t suppressedWrites;   ///< Driver updates skipped (unchanged)
+    uint8_t brightness;      ///< Global output brightness (driver dimming)
+    bool partialUpdates;     ///< Driver supports updateChannels()
+    bool asyncTransfers;     ///< Driver supports submit()
+    portMUX_TYPE asyncMux;   ///< Guards the transfer pipeline (ISR-safe)
+    bool transferBusy;       ///< One transfer in flight
+    bool transferPending;    ///< pendingOutput waits for the bus
+    bool transferFailed;     ///< Pump task submit failed: lastOutput is stale
+    LatchState pendingOutput;
+    TaskHandle_t pumpTask;   ///< Submits coalesced output after completion
+    LatchCommandQueue* commandQueue;   ///< Owner task mode only
+    TaskHandle_t ownerTask;
+    volatile bool ownerStop;
+    std::atomic<bool> ownerAccepting;   ///< post() may push to the queue
+    std::atomic<uint16_t> ownerPosts;   ///< post() calls inside the gate
+    std::atomic<uint32_t> droppedCommands;   ///< Producers count concurrently
+    esp_timer_handle_t serviceTimer;   ///< Deferred work (flush window, ...)
+    int64_t serviceDue;      ///< Armed service deadline (0 = idle)
+    uint32_t flushIntervalUs;    ///< Coalescing window (0 = write immediately)
+    bool flushPending;       ///< Changes wait for the window to close
+    int64_t lastFlushUs;     ///< Time of the last hardware write
+    LatchState timedActive;  ///< Channels with a pending timed revert
+    LatchState timedRevert;  ///< State applied when the deadline expires
+    int64_t timedUntil[LATCH_MAX_CHANNELS];   ///< Revert deadline per channel
+    ProtectionSlot* protection;   ///< Allocated on first setProtection()
+    LatchState deferred;     ///< Accepted changes waiting for their limits
+    uint32_t deferredSwitches;
+    uint32_t rejectedSwitches;
+    uint16_t staggerSize;    ///< Switch-ons per step (0 = no staggering)
+    int64_t staggerIntervalUs;
+    int64_t staggerStepUs;   ///< Start of the current step
+    uint16_t staggerCount;   ///< Switch-ons in the current step
+    uint8_t lockDepth;       ///< Recursion level of takeLock()
+    ObserverSlot observers[LATCH_MAX_OBSERVERS];
+    std::atomic<uint8_t> observerCalls[LATCH_MAX_OBSERVERS];   ///< Notifications in progress
+    LatchState publishedState;   ///< Applied state at the last change
+    LatchChange pendingChange;   ///< Delivered when the lock is released
+    bool changePending;
+    uint32_t changeSequence;
+    std::atomic<uint32_t> snapshotSeq;   ///< Seqlock counter (odd = writing)
+    portMUX_TYPE snapshotMux;    ///< Keeps the writer from being preempted
+    LatchSnapshot snapshot;
+    uint32_t* remapTable;    ///< Nibble-wise permutation tables (nullptr = identity)
+    uint8_t remapNibbles;    ///< Input nibbles covered by remapTable
+    LatchState polarityOverride;  ///< Channels with their own trigger mode
+    LatchState polarityLow;  ///< Override value: ACTIVE_LOW
+    LatchState outputInvert; ///< Physical XOR mask (trigger mode + overrides)
+    LatchState powerOnState; ///< State written by begin()
 
     void takeLock();
+    bool tryTakeLock();
     void giveLock();
+    void commitLocked();
+    void writeHardware(bool force = false);
+    bool submitOutput(const LatchState& output);
+    void onTransferComplete();
+    void pumpLoop();
+    static void transferCompleteEntry(void* context);
+    static void pumpTaskEntry(void* param);
+    bool executeCommand(const LatchCommand& command);
+    void ownerLoop();
+    static void ownerTaskEntry(void* param);
+    void scheduleService(int64_t due);
+    void runService();
+    void expireTimed(int64_t now);
+    void updateApplied(bool allowReject = true);
+    void recordChange();
+    void publishSnapshot(int64_t now);
+    void remapOutput(const LatchState& logical, LatchState& physical);
+    void updateOutputInvert();
+    void modifyBits(const uint32_t* value, const uint32_t* mask, uint8_t wordCount,
+                    bool toggle, uint32_t* previous);
+    int64_t switchAllowedAt(uint16_t channel, bool state);
+    static void serviceTimerEntry(void* arg);
 
 public:
     /**
      * @brief Constructor
      * @param driver Hardware driver for the IC type
-     * @param channels Number of channels (e.g., 8 for 74HC595)
+     * @param channels Number of channels (e.g., 8 for 74HC595),
+     *                 limited to LATCH_MAX_CHANNELS
      */
-    LatchController(LatchDriver* driver, uint8_t channels = 8);
+    LatchController(LatchDriver* driver, uint16_t channels = 8);
 
     /**
      * @brief Destructor - cleans up mutex
@@ -96,49 +375,114 @@ public:
      * @brief Initialize the controller
      * @param mode Trigger mode (ACTIVE_HIGH or ACTIVE_LOW)
      * @return true on success
+     * @note The first hardware write shows the power-on state
+     *       (all OFF unless set with setPowerOnState())
      */
     bool begin(LatchTriggerMode mode = ACTIVE_HIGH);
 
+    /**
+     * @brief Set the state applied by begin()
+     * 
+     * Used by LatchPersistence to restore the last saved state after a
+     * reset without switching the outputs OFF first.
+     * 
+     * @param words State words (bit n of words[0] = channel n, etc.)
+     * @param wordCount Number of words in the array; missing words are OFF
+     * @note Call before begin(). Protection limits and staggering do
+     *       not apply to the power-on state.
+     */
+    void setPowerOnState(const uint32_t* words, uint8_t wordCount);
+
     // ========== Single Channel Control ==========
 
     /**
      * @brief Set a single latch state
      * @param channel Channel number (0 to channelCount-1)
      * @param state true = ON (logical), false = OFF (logical)
-     * @return true on success
+     * @return true on success, false if invalid or rejected by
+     *         LATCH_PROTECT_REJECT limits (inside a batch, rejections
+     *         happen at commit() and are only counted)
      * @note Hardware inversion for ACTIVE_LOW is handled internally
      */
-    bool setLatch(uint8_t channel, bool state);
+    bool setLatch(uint16_t channel, bool state);
 
     /**
      * @brief Turn a latch ON (logical state)
      * @param channel Channel number
      * @return true on success
      */
-    bool setLatchOn(uint8_t channel);
+    bool setLatchOn(uint16_t channel);
 
     /**
      * @brief Turn a latch OFF (logical state)
      * @param channel Channel number
      * @return true on success
      */
-    bool setLatchOff(uint8_t channel);
+    bool setLatchOff(uint16_t channel);
 
     /**
      * @brief Toggle a latch state
      * @param channel Channel number
      * @return true on success
      */
-    bool toggleLatch(uint8_t channel);
+    bool toggleLatch(uint16_t channel);
+
+    // ========== Timed Control ==========
+
+    /**
+     * @brief Set a latch state for a limited time
+     * 
+     * The channel is set now and reverted to the opposite state after
+     * the duration. All deadlines are handled by the controller's
+     * service timer; deadlines expiring together cause one hardware
+     * update. Any other write to the channel cancels the revert.
+     * 
+     * @param channel Channel number
+     * @param state State to hold (logical)
+     * @param durationMs Hold time in milliseconds (0 = permanent)
+     * @return true on success
+     */
+    bool setLatchFor(uint16_t channel, bool state, uint32_t durationMs);
+
+    /**
+     * @brief Turn a latch ON for a limited time (door strikes, valves)
+     * @param channel Channel number
+     * @param durationMs Pulse length in milliseconds
+     * @return true on success
+     */
+    bool pulseLatch(uint16_t channel, uint32_t durationMs);
+
+    /**
+     * @brief Cancel a pending timed revert, keeping the current state
+     * @param channel Channel number
+     * @return true if a revert was pending
+     */
+    bool cancelLatchTimer(uint16_t channel);
+
+    /**
+     * @brief Get time left until a timed revert
+     * @param channel Channel number
+     * @return Remaining milliseconds (0 = no revert pending)
+     */
+    uint32_t getLatchTimer(uint16_t channel);
 
     // ========== Bulk Control ==========
 
     /**
      * @brief Set all latches from bit mask
      * @param mask Bit mask (bit 0 = channel 0, etc.)
+     * @note Channels 32 and above are turned OFF
      */
     void setAllLatches(uint32_t mask);
 
+    /**
+     * @brief Set all latches from a multi-word bit mask
+     * @param words Bit mask words (bit n of words[0] = channel n,
+     *              bit n of words[1] = channel 32 + n, etc.)
+     * @param wordCount Number of words in the array; missing words are OFF
+     */
+    void setAllLatches(const uint32_t* words, uint8_t wordCount);
+
     /**
      * @brief Turn all latches ON
      */
@@ -149,28 +493,447 @@ public:
      */
     void setAllOff();
 
+    // ========== Masked Updates ==========
+    //
+    // Read-modify-write of a channel group under the controller lock:
+    // one hardware update, no race with other tasks, no batch needed.
+    // The return value is the logical state of channels 0-31 before
+    // the update.
+
+    /**
+     * @brief Turn the masked channels ON, keep all others
+     * @param mask Channels to turn ON (bit 0 = channel 0, etc.)
+     * @return Previous state of channels 0-31
+     */
+    uint32_t setBits(uint32_t mask);
+
+    /**
+     * @brief Turn the masked channels OFF, keep all others
+     * @param mask Channels to turn OFF
+     * @return Previous state of channels 0-31
+     */
+    uint32_t clearBits(uint32_t mask);
+
+    /**
+     * @brief Toggle the masked channels, keep all others
+     * @param mask Channels to toggle
+     * @return Previous state of channels 0-31
+     */
+    uint32_t toggleBits(uint32_t mask);
+
+    /**
+     * @brief Copy the masked bits of value, keep all other channels
+     * @param value New states (only bits set in mask are used)
+     * @param mask Channels to write
+     * @return Previous state of channels 0-31
+     */
+    uint32_t writeMasked(uint32_t value, uint32_t mask);
+
+    /**
+     * @brief Multi-word writeMasked()
+     * @param value New state words
+     * @param mask Channel words to write; missing words are unchanged
+     * @param wordCount Number of words in value and mask
+     * @param previous Optional destination for the previous state
+     *                 (wordCount words)
+     */
+    void writeMasked(const uint32_t* value, const uint32_t* mask, uint8_t wordCount,
+                     uint32_t* previous = nullptr);
+
+    /**
+     * @brief Multi-word toggleBits()
+     * @param mask Channel words to toggle; missing words are unchanged
+     * @param wordCount Number of words in mask
+     * @param previous Optional destination for the previous state
+     *                 (wordCount words)
+     */
+    void toggleBits(const uint32_t* mask, uint8_t wordCount, uint32_t* previous = nullptr);
+
+    // ========== Write Coalescing ==========
+
+    /**
+     * @brief Limit hardware writes to one per interval
+     * 
+     * Single writes (setLatch(), toggleLatch(), setAllLatches(), ...)
+     * only mark the controller dirty while the window is open; one
+     * flush then writes the newest state. An isolated write after a
+     * quiet period is flushed at once, so the worst-case latency is
+     * one interval. Batches, refresh() and flush() write immediately.
+     * 
+     * @param intervalUs Minimum time between writes in microseconds
+     *                   (0 = write on every change, the default)
+     */
+    void setFlushInterval(uint32_t intervalUs);
+
+    /**
+     * @brief Get the coalescing window
+     * @return Interval in microseconds (0 = disabled)
+     */
+    uint32_t getFlushInterval();
+
+    /**
+     * @brief Write pending changes now instead of at the end of the window
+     */
+    void flush();
+
+    // ========== Relay Protection ==========
+
+    /**
+     * @brief Limit switching of a channel
+     * 
+     * Enforced for every write: minimum ON/OFF dwell and a maximum
+     * number of switches per window (short bursts up to maxSwitches
+     * pass, sustained rate is maxSwitches per window). Violating
+     * requests are deferred until allowed or rejected, depending on
+     * the mode. Deferred requests coalesce: toggling back before the
+     * deadline cancels the change.
+     * 
+     * @param channel Channel number
+     * @param limits Limits for this channel (all zero = unprotected)
+     * @return false on invalid channel or if the limit table cannot be
+     *         allocated (previous limits stay in effect)
+     * @note getLatchState() reports the requested state; use
+     *       isLatchPending() to see if the hardware still lags behind.
+     */
+    bool setProtection(uint16_t channel, const LatchProtection& limits);
+
+    /**
+     * @brief Apply the same limits to all channels
+     * @param limits Limits for every channel
+     * @return false if the limit table cannot be allocated
+     */
+    bool setProtection(const LatchProtection& limits);
+
+    /**
+     * @brief Remove all limits and apply deferred changes now
+     */
+    void clearProtection();
+
+    /**
+     * @brief Check if a requested change waits for its protection limits
+     * @param channel Channel number
+     * @return true while the hardware does not show the requested state
+     */
+    bool isLatchPending(uint16_t channel);
+
+    /**
+     * @brief Get number of switch requests deferred by protection limits
+     * @return Deferred count since begin() or resetStatistics()
+     */
+    uint32_t getDeferredSwitches();
+
+    /**
+     * @brief Get number of switch requests rejected by protection limits
+     * @return Rejected count since begin() or resetStatistics()
+     */
+    uint32_t getRejectedSwitches();
+
+    // ========== Inrush Staggering ==========
+
+    /**
+     * @brief Spread switch-ons over time to limit inrush current
+     * 
+     * Bulk writes (setAllOn(), setAllLatches(), batches) would energize
+     * every coil in one latch strobe. With staggering, at most
+     * channelsPerStep channels turn ON per step; the service timer
+     * applies the remaining ones step by step without blocking the
+     * caller. Turn-offs are always applied immediately.
+     * 
+     * @param channelsPerStep Switch-ons per step (0 = disable)
+     * @param stepMs Time between steps in milliseconds
+     */
+    void setStagger(uint16_t channelsPerStep, uint32_t stepMs);
+
+    // ========== Output Mask ==========
+
+    /**
+     * @brief Gate the hardware output with a channel mask
+     * 
+     * Channels whose mask bit is clear are driven OFF on the hardware
+     * while their logical state is kept. Used by LatchDimmer to apply
+     * modulation bitplanes through the regular update path.
+     * 
+     * @param words Mask words (bit n of words[0] = channel n, etc.)
+     * @param wordCount Number of words in the array; missing words are 0
+     */
+    void setOutputMask(const uint32_t* words, uint8_t wordCount);
+
+    /**
+     * @brief Remove the output mask (all channels follow their state)
+     */
+    void clearOutputMask();
+
+    // ========== Channel Mapping ==========
+
+    /**
+     * @brief Route logical channels to different physical outputs
+     * 
+     * For boards where relay N is not wired to output bit N. The map is
+     * compiled into nibble-wise lookup tables: remapping costs one table
+     * lookup per 4 channels on each write instead of a loop over bits.
+     * 
+     * @param physical physical[n] = output bit driven by channel n;
+     *                 must be a permutation of 0 to channelCount-1
+     * @param count Number of entries (must equal getChannelCount())
+     * @return false if the map is invalid or the tables do not fit
+     * @note Tables take about channelCount^2 / 2 bytes of heap
+     *       (512 B for 32 channels, 8 KB for 128)
+     */
+    bool setChannelMap(const uint16_t* physical, uint16_t count);
+
+    /**
+     * @brief Remove the channel map (channel N drives output bit N)
+     */
+    void clearChannelMap();
+
+    /**
+     * @brief Give a channel its own trigger mode
+     * 
+     * Mixes ACTIVE_HIGH and ACTIVE_LOW loads on one chain. Overrides are
+     * folded into the precomputed output XOR mask, so they cost nothing
+     * per write. setTriggerMode() keeps overridden channels unchanged.
+     * 
+     * @param channel Channel number (logical)
+     * @param mode Trigger mode for this channel
+     * @return true on success
+     */
+    bool setChannelPolarity(uint16_t channel, LatchTriggerMode mode);
+
+    /**
+     * @brief Remove all per-channel trigger modes
+     */
+    void clearChannelPolarity();
+
+    // ========== Brightness ==========
+
+    /**
+     * @brief Dim all outputs in hardware
+     * 
+     * Forwarded to drivers with a global dimming feature, e.g.
+     * ShiftRegisterDriver with OE on a LEDC PWM channel. Costs no CPU
+     * time and no additional bus transfers.
+     * 
+     * @param level 0 (dark) to 255 (full brightness)
+     * @return false if the driver does not support brightness control
+     */
+    bool setBrightness(uint8_t level);
+
+    /**
+     * @brief Get global output brightness
+     * @return Last level set with setBrightness() (255 by default)
+     */
+    uint8_t getBrightness();
+
+    // ========== Change Notification ==========
+
+    /**
+     * @brief Register an observer for committed state changes
+     * 
+     * The observer is called once per hardware update that changed the
+     * applied state, with the changes of a whole batch combined. It runs
+     * after the controller lock has been released, in the task that
+     * committed the change (caller, owner task or service timer).
+     * 
+     * Observers may run concurrently for updates from different tasks;
+     * use LatchChange::sequence to discard outdated notifications.
+     * 
+     * @param observer Function to call
+     * @param context Passed to the observer
+     * @return Observer id for unsubscribe(), -1 if all slots are in use
+     */
+    int8_t subscribe(LatchObserver observer, void* context = nullptr);
+
+    /**
+     * @brief Remove an observer
+     * 
+     * Waits until notifications already being delivered to this
+     * observer have returned, so its context can be destroyed afterwards.
+     * 
+     * @param id Id returned by subscribe()
+     * @note Must not be called from the observer itself.
+     */
+    void unsubscribe(int8_t id);
+
+    // ========== Batch Control ==========
+
+    /**
+     * @brief Start a batch of changes
+     * 
+     * Takes the controller lock and defers all hardware updates until
+     * the matching commit(). Other tasks block until the batch is
+     * committed. Batches may be nested; only the outermost commit()
+     * writes to the hardware.
+     * 
+     * @note Must be paired with commit() from the same task.
+     *       Prefer LatchTransaction for scope-bound batches.
+     */
+    void beginBatch();
+
+    /**
+     * @brief Start a batch without waiting for the lock
+     * 
+     * Like beginBatch(), but returns false at once while another task
+     * holds the controller lock. Meant for esp_timer callbacks, which
+     * must never block: re-arm the timer and try again later.
+     * 
+     * @return true if the batch was started (pair it with commit())
+     */
+    bool tryBeginBatch();
+
+    /**
+     * @brief Finish a batch and flush all accumulated changes
+     * 
+     * Writes the hardware exactly once if any channel changed during
+     * the batch, then releases the controller lock.
+     */
+    void commit();
+
+    /**
+     * @brief Check if a batch is currently open
+     * @return true between beginBatch() and the outermost commit()
+     */
+    bool isBatchActive();
+
+    // ========== Owner Task ==========
+
+    /**
+     * @brief Hand the driver to a dedicated pinned task
+     * 
+     * Commands posted with post()/postLatch()/... are queued in a
+     * lock-free ring and executed by the owner task, which applies
+     * everything queued since its last wake-up as one batch. Posting
+     * tasks (e.g. AsyncTCP on Core 0) never wait for a bus transfer.
+     * 
+     * @param core CPU core for the owner task
+     * @param priority FreeRTOS priority of the owner task
+     * @param queueSize Command slots (rounded up to a power of two)
+     * @param stackSize Task stack size in bytes
+     * @return false if begin() was not called or the queue or task
+     *         cannot be created
+     * @note Call after begin(). Direct calls (setLatch() etc.) keep
+     *       working but take the controller lock as before.
+     */
+    bool startOwnerTask(uint8_t core = 1, UBaseType_t priority = 5,
+                        uint16_t queueSize = 32, uint32_t stackSize = 3072);
+
+    /**
+     * @brief Stop the owner task after draining queued commands
+     * 
+     * New posts execute directly from this point; posts already inside
+     * the queue are applied, leftovers complete with false.
+     * 
+     * @note Must not be called from the owner task.
+     */
+    void stopOwnerTask();
+
+    /**
+     * @brief Check if the owner task is running
+     * @return true in owner task mode
+     */
+    bool hasOwnerTask();
+
+    /**
+     * @brief Post a command to the owner task
+     * @param command Command to execute
+     * @return true if queued, false if the queue is full
+     * @note Without owner task the command executes immediately.
+     */
+    bool post(const LatchCommand& command);
+
+    /**
+     * @brief Post a single channel write
+     * @param channel Channel number
+     * @param state true = ON (logical), false = OFF (logical)
+     * @param completion Optional handle signalled after the hardware update
+     * @return true if queued
+     */
+    bool postLatch(uint16_t channel, bool state, LatchCompletion* completion = nullptr);
+
+    /**
+     * @brief Post a channel toggle
+     * @param channel Channel number
+     * @param completion Optional handle signalled after the hardware update
+     * @return true if queued
+     */
+    bool postToggle(uint16_t channel, LatchCompletion* completion = nullptr);
+
+    /**
+     * @brief Post a timed channel write (see setLatchFor())
+     * @param channel Channel number
+     * @param state State to hold (logical)
+     * @param durationMs Hold time in milliseconds
+     * @param completion Optional handle signalled after the hardware update
+     * @return true if queued
+     */
+    bool postLatchFor(uint16_t channel, bool state, uint32_t durationMs,
+                      LatchCompletion* completion = nullptr);
+
+    /**
+     * @brief Post a bulk write of channels 0-31
+     * @param mask Bit mask (bit 0 = channel 0, etc.)
+     * @param completion Optional handle signalled after the hardware update
+     * @return true if queued
+     */
+    bool postAllLatches(uint32_t mask, LatchCompletion* completion = nullptr);
+
+    /**
+     * @brief Get number of commands rejected because the queue was full
+     * @return Dropped command count
+     */
+    uint32_t getDroppedCommands();
+
     // ========== State Query ==========
 
     /**
      * @brief Get single latch state (logical)
      * @param channel Channel number
      * @return true if ON (logical), false if OFF
+     * @note Reads without the lock; use getSnapshot() for a consistent
+     *       multi-channel view from other tasks.
      */
-    bool getLatchState(uint8_t channel);
+    bool getLatchState(uint16_t channel);
 
     /**
      * @brief Get all latch states as bit mask (logical)
-     * @return Bit mask of all states
+     * @return Bit mask of channels 0-31
      */
     uint32_t getAllStates();
 
+    /**
+     * @brief Get all latch states as multi-word bit mask (logical)
+     * @param words Destination array
+     * @param wordCount Number of words to copy (see getWordCount())
+     */
+    void getAllStates(uint32_t* words, uint8_t wordCount);
+
+    /**
+     * @brief Read the applied state without taking the lock
+     * 
+     * Seqlock: writers publish each committed change with a sequence
+     * number and timestamp, readers copy and retry if a write overlapped.
+     * Readers never block writers or each other, so web handlers and
+     * other high-frequency pollers can call this at any rate. Compare
+     * sequence with the last poll to detect changes.
+     * 
+     * @param out Destination snapshot
+     * @note Reports the state driven to the hardware: a change waiting
+     *       for the flush window or protection limits is not yet visible.
+     */
+    void getSnapshot(LatchSnapshot& out);
+
     // ========== Configuration ==========
 
     /**
      * @brief Get channel count
      * @return Number of configured channels
      */
-    uint8_t getChannelCount();
+    uint16_t getChannelCount();
+
+    /**
+     * @brief Get number of 32-bit words holding the channel state
+     * @return Word count for the configured channels
+     */
+    uint8_t getWordCount();
 
     /**
      * @brief Change trigger mode at runtime
@@ -184,12 +947,81 @@ public:
      */
     bool isInitialized();
 
+    // ========== Statistics ==========
+
+    /**
+     * @brief Rewrite the hardware even if the output did not change
+     * 
+     * Writes are normally skipped when the output word equals the last
+     * one sent to the driver. Use this to re-assert the outputs, e.g.
+     * after a power glitch on the latch ICs.
+     */
+    void refresh();
+
+    /**
+     * @brief Get number of driver updates performed
+     * @return Hardware write count since begin() or resetStatistics()
+     */
+    uint32_t getHardwareWrites();
+
+    /**
+     * @brief Get number of driver updates skipped because nothing changed
+     * @return Suppressed write count since begin() or resetStatistics()
+     */
+    uint32_t getSuppressedWrites();
+
+    /**
+     * @brief Reset hardware/suppressed write counters
+     */
+    void resetStatistics();
+
+    /**
+     * @brief Check if an asynchronous transfer is still running
+     * @return true while the driver has not completed the last submit()
+     *         or a coalesced output waits for the bus
+     */
+    bool isTransferBusy();
+
     /**
      * @brief Print debug information to Serial
      */
     void printDebugInfo();
 };
 
+// ============================================================
+// LatchTransaction (RAII Batch Helper)
+// ============================================================
+
+/**
+ * @class LatchTransaction
+ * @brief Scope guard for LatchController::beginBatch()/commit()
+ * 
+ * @code
+ * {
+ *     LatchTransaction tx(relays);
+ *     relays.setLatchOn(0);
+ *     relays.setLatchOn(5);
+ *     relays.setLatchOff(7);
+ * }   // one hardware update here
+ * @endcode
+ */
+class LatchTransaction {
+private:
+    LatchController& controller;
+
+public:
+    explicit LatchTransaction(LatchController& ctrl) : controller(ctrl) {
+        controller.beginBatch();
+    }
+
+    ~LatchTransaction() {
+        controller.commit();
+    }
+
+    LatchTransaction(const LatchTransaction&) = delete;
+    LatchTransaction& operator=(const LatchTransaction&) = delete;
+};
+
 // ============================================================
 // LatchDriver Interface (Abstract Base Class)
 // ============================================================
@@ -201,6 +1033,17 @@ public:
  * Implement this interface to support new IC types.
  */
 class LatchDriver {
+private:
+    LatchTransferCallback transferCallback = nullptr;
+    void* transferContext = nullptr;
+
+protected:
+    /**
+     * @brief Signal that the transfer started by submit() has finished
+     * @note Safe to call from task or ISR context (placed in IRAM)
+     */
+    void transferComplete();
+
 public:
     virtual ~LatchDriver() {}
 
@@ -217,6 +1060,59 @@ public:
      */
     virtual void updateHardware(uint32_t data, uint8_t channelCount) = 0;
 
+    /**
+     * @brief Update hardware output with a multi-word bit pattern
+     * 
+     * Called by LatchController for every update. The default forwards
+     * the first word to updateHardware(); drivers supporting more than
+     * 32 channels override this to output the whole pattern at once.
+     * 
+     * @param data Bit pattern words (bit n of data[w] = channel 32*w + n)
+     * @param channelCount Number of channels to update
+     */
+    virtual void updateHardwareWords(const uint32_t* data, uint16_t channelCount) {
+        updateHardware(data[0], channelCount > 32 ? 32 : (uint8_t)channelCount);
+    }
+
+    /**
+     * @brief Check if the driver can write only the changed channels
+     * @return true if updateChannels() does a partial update
+     * @note Queried once in LatchController::begin()
+     */
+    virtual bool supportsPartialUpdate() {
+        return false;
+    }
+
+    /**
+     * @brief Update only the channels that changed since the last update
+     * 
+     * Called instead of updateHardwareWords() when supportsPartialUpdate()
+     * returns true and the previous output is known. Drivers can skip
+     * unchanged pins or expander ports. The default performs a full update.
+     * 
+     * @param data Complete new bit pattern (already inverted if ACTIVE_LOW)
+     * @param changedMask Bits that differ from the previous output
+     * @param channelCount Number of channels
+     */
+    virtual void updateChannels(const uint32_t* data, const uint32_t* /*changedMask*/, uint16_t channelCount) {
+        updateHardwareWords(data, channelCount);
+    }
+
+    /**
+     * @brief Check if the driver can dim all outputs in hardware
+     * @return true if setBrightness() has an effect
+     */
+    virtual bool supportsBrightness() {
+        return false;
+    }
+
+    /**
+     * @brief Set global output brightness
+     * @param level 0 (dark) to 255 (full brightness)
+     */
+    virtual void setBrightness(uint8_t /*level*/) {
+    }
+
     /**
      * @brief Get driver name for debugging
      * @return Driver name string
@@ -225,9 +1121,56 @@ public:
 
     /**
      * @brief Get maximum supported channels
-     * @return Maximum channel count
+     * @return Maximum channel count (255 or less, see getChannelCapacity())
      */
     virtual uint8_t getMaxChannels() = 0;
+
+    /**
+     * @brief Get maximum supported channels beyond 255
+     * @return Maximum channel count; the default forwards getMaxChannels()
+     */
+    virtual uint16_t getChannelCapacity() {
+        return getMaxChannels();
+    }
+
+    // ========== Asynchronous Transfers (optional) ==========
+
+    /**
+     * @brief Check if the driver performs non-blocking transfers
+     * @return true if submit() returns before the transfer has finished
+     * @note Queried once in LatchController::begin(), after init()
+     */
+    virtual bool supportsAsync() {
+        return false;
+    }
+
+    /**
+     * @brief Start a non-blocking hardware update
+     * 
+     * Must copy the data and return immediately. LatchController keeps
+     * at most one transfer in flight, so submit() is never called again
+     * before transferComplete() was signalled. The default performs a
+     * synchronous update and completes immediately.
+     * 
+     * @param data Bit pattern words (already inverted if ACTIVE_LOW)
+     * @param channelCount Number of channels to update
+     * @return true if the transfer was started
+     */
+    virtual bool submit(const uint32_t* data, uint16_t channelCount) {
+        updateHardwareWords(data, channelCount);
+        transferComplete();
+        return true;
+    }
+
+    /**
+     * @brief Register the completion callback (used by LatchController)
+     * @param callback Function called by transferComplete()
+     * @param context Passed to the callback
+     */
+    void setTransferCallback(LatchTransferCallback callback, void* context) {
+        transferContext = context;
+        transferCallback = callback;
+    }
 };
 
 #endif // LATCH_CONTROLLER_H
@@ -0,0 +1,234 @@
+/**
+ * @file LatchControllerT.h
+ * @brief Compile-time specialized Latch Controller
+ * @version 3.0.0
+ * @author MROutake
+ *
+ * Template variant of LatchController for tight sequencing loops.
+ * Channel count, trigger mode and driver type are template parameters,
+ * so channel masks and ACTIVE_LOW inversion fold into constants and
+ * driver calls bypass the virtual LatchDriver interface.
+ *
+ * Limitations compared to LatchController:
+ * - Up to 32 channels
+ * - Trigger mode fixed at compile time
+ * - No batches or statistics
+ *
+ * @code
+ * ShiftRegisterDriver driver(23, 18, 19);
+ * LatchControllerT<ShiftRegisterDriver, 8, ACTIVE_LOW> relays(driver);
+ *
+ * relays.begin();
+ * relays.setLatch<3>(true);   // mask resolved at compile time
+ * @endcode
+ */
+
+#ifndef LATCH_CONTROLLER_T_H
+#define LATCH_CONTROLLER_T_H
+
+#include "LatchController.h"
+
+/**
+ * @class LatchControllerT
+ * @brief Thread-safe latch controller resolved at compile time
+ * @tparam Driver Concrete driver class (derived from LatchDriver)
+ * @tparam Channels Number of channels (1-32)
+ * @tparam Mode Trigger mode (ACTIVE_HIGH or ACTIVE_LOW)
+ */
+template <class Driver, uint8_t Channels, LatchTriggerMode Mode = ACTIVE_HIGH>
+class LatchControllerT {
+    static_assert(Channels >= 1 && Channels <= 32, "LatchControllerT supports 1 to 32 channels");
+
+public:
+    /// Bit mask of all valid channels
+    static constexpr uint32_t CHANNEL_MASK = (Channels == 32) ? 0xFFFFFFFFUL : ((1UL << Channels) - 1);
+
+    /// XOR mask turning logical state into hardware output
+    static constexpr uint32_t OUTPUT_INVERT = (Mode == ACTIVE_LOW) ? 0xFFFFFFFFUL : 0;
+
+private:
+    Driver& driver;
+    uint32_t currentState;
+    uint32_t lastOutput;
+    bool initialized;
+    SemaphoreHandle_t lock;
+
+    void takeLock() {
+        if (lock != nullptr) {
+            xSemaphoreTake(lock, portMAX_DELAY);
+        }
+    }
+
+    void giveLock() {
+        if (lock != nullptr) {
+            xSemaphoreGive(lock);
+        }
+    }
+
+    // Qualified call: no virtual dispatch through LatchDriver
+    void writeHardware() {
+        uint32_t outputData = currentState ^ OUTPUT_INVERT;
+        if (outputData != lastOutput) {
+            driver.Driver::updateHardware(outputData, Channels);
+            lastOutput = outputData;
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param drv Hardware driver instance
+     */
+    explicit LatchControllerT(Driver& drv)
+        : driver(drv)
+        , currentState(0)
+        , lastOutput(0)
+        , initialized(false)
+        , lock(nullptr)
+    {
+    }
+
+    /**
+     * @brief Destructor - cleans up mutex
+     */
+    ~LatchControllerT() {
+        if (lock != nullptr) {
+            vSemaphoreDelete(lock);
+            lock = nullptr;
+        }
+    }
+
+    LatchControllerT(const LatchControllerT&) = delete;
+    LatchControllerT& operator=(const LatchControllerT&) = delete;
+
+    /**
+     * @brief Initialize driver and turn all outputs OFF
+     * @return true on success
+     */
+    bool begin() {
+        if (lock == nullptr) {
+            lock = xSemaphoreCreateMutex();
+            if (lock == nullptr) {
+                Serial.println("[LatchControllerT] ERROR: Failed to create mutex!");
+                return false;
+            }
+        }
+
+        if (!driver.Driver::init()) {
+            Serial.println("[LatchControllerT] ERROR: Driver init failed!");
+            return false;
+        }
+
+        currentState = 0;
+        lastOutput = OUTPUT_INVERT;
+        driver.Driver::updateHardware(lastOutput, Channels);
+
+        initialized = true;
+        return true;
+    }
+
+    // ========== Single Channel Control ==========
+
+    /**
+     * @brief Set a single latch state (channel known at compile time)
+     * @tparam Channel Channel number (0 to Channels-1)
+     * @param state true = ON (logical), false = OFF (logical)
+     */
+    template <uint8_t Channel>
+    void setLatch(bool state) {
+        static_assert(Channel < Channels, "Channel out of range");
+        takeLock();
+        currentState = state ? (currentState | (1UL << Channel)) : (currentState & ~(1UL << Channel));
+        writeHardware();
+        giveLock();
+    }
+
+    /**
+     * @brief Set a single latch state
+     * @param channel Channel number (0 to Channels-1)
+     * @param state true = ON (logical), false = OFF (logical)
+     * @return true on success
+     */
+    bool setLatch(uint8_t channel, bool state) {
+        if (channel >= Channels) {
+            Serial.printf("[LatchControllerT] ERROR: Invalid channel %d (max: %d)\n",
+                          channel, Channels - 1);
+            return false;
+        }
+        takeLock();
+        currentState = state ? (currentState | (1UL << channel)) : (currentState & ~(1UL << channel));
+        writeHardware();
+        giveLock();
+        return true;
+    }
+
+    bool setLatchOn(uint8_t channel) {
+        return setLatch(channel, true);
+    }
+
+    bool setLatchOff(uint8_t channel) {
+        return setLatch(channel, false);
+    }
+
+    /**
+     * @brief Toggle a latch state
+     * @param channel Channel number
+     * @return true on success
+     */
+    bool toggleLatch(uint8_t channel) {
+        if (channel >= Channels) {
+            Serial.printf("[LatchControllerT] ERROR: Invalid channel %d\n", channel);
+            return false;
+        }
+        takeLock();
+        currentState ^= (1UL << channel);
+        writeHardware();
+        giveLock();
+        return true;
+    }
+
+    // ========== Bulk Control ==========
+
+    /**
+     * @brief Set all latches from bit mask
+     * @param mask Bit mask (bit 0 = channel 0, etc.)
+     */
+    void setAllLatches(uint32_t mask) {
+        takeLock();
+        currentState = mask & CHANNEL_MASK;
+        writeHardware();
+        giveLock();
+    }
+
+    void setAllOn() {
+        setAllLatches(CHANNEL_MASK);
+    }
+
+    void setAllOff() {
+        setAllLatches(0);
+    }
+
+    // ========== State Query ==========
+
+    bool getLatchState(uint8_t channel) const {
+        return channel < Channels && (currentState & (1UL << channel)) != 0;
+    }
+
+    uint32_t getAllStates() const {
+        return currentState;
+    }
+
+    static constexpr uint8_t getChannelCount() {
+        return Channels;
+    }
+
+    static constexpr LatchTriggerMode getTriggerMode() {
+        return Mode;
+    }
+
+    bool isInitialized() const {
+        return initialized;
+    }
+};
+
+#endif // LATCH_CONTROLLER_T_H
@@ -0,0 +1,189 @@
+/**
+ * @file LatchDimmer.cpp
+ * @brief Binary code modulation implementation
+ * @version 3.0.0
+ */
+
+#include "LatchDimmer.h"
+
+LatchDimmer::LatchDimmer(LatchController& ctrl, uint8_t resolution)
+    : controller(ctrl)
+    , bits(constrain(resolution, (uint8_t)1, (uint8_t)LATCH_DIMMER_MAX_BITS))
+    , timer(nullptr)
+    , baseUs(0)
+    , plane(0)
+    , deadline(0)
+    , running(false)
+{
+    // Default: fully on in every plane (plain on/off behavior)
+    for (uint16_t i = 0; i < LATCH_MAX_CHANNELS; i++) {
+        levels[i] = getMaxLevel();
+    }
+    for (uint8_t b = 0; b < LATCH_DIMMER_MAX_BITS; b++) {
+        planes[b].fill(LATCH_MAX_CHANNELS);
+    }
+    portMUX_INITIALIZE(&planeMux);
+}
+
+LatchDimmer::~LatchDimmer() {
+    end();
+    if (timer != nullptr) {
+        esp_timer_stop(timer);   // a lock retry may have re-armed it
+        esp_timer_delete(timer);
+        timer = nullptr;
+    }
+}
+
+bool LatchDimmer::begin(uint32_t baseIntervalUs) {
+    if (!controller.isInitialized()) {
+        Serial.println("[LatchDimmer] ERROR: Controller not initialized!");
+        return false;
+    }
+    if (baseIntervalUs == 0) {
+        Serial.println("[LatchDimmer] ERROR: Invalid base interval!");
+        return false;
+    }
+    if (running) {
+        return true;
+    }
+
+    if (timer == nullptr) {
+        esp_timer_create_args_t args = {};
+        args.callback = timerEntry;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "LatchDimmer";
+        if (esp_timer_create(&args, &timer) != ESP_OK) {
+            Serial.println("[LatchDimmer] ERROR: Failed to create timer!");
+            timer = nullptr;
+            return false;
+        }
+    }
+
+    // Same lock as the timer callback. Stop unconditionally: a lock
+    // retry from onTimer() racing with end() may have left it armed.
+    controller.beginBatch();
+    esp_timer_stop(timer);
+
+    baseUs = baseIntervalUs;
+    plane = 0;
+    deadline = esp_timer_get_time();
+    running = true;
+    esp_err_t err = esp_timer_start_once(timer, 1);
+    if (err == ESP_ERR_INVALID_STATE) {
+        // Re-armed by a callback that was already running
+        esp_timer_stop(timer);
+        err = esp_timer_start_once(timer, 1);
+    }
+    if (err != ESP_OK) {
+        running = false;
+    }
+    controller.commit();
+
+    if (!running) {
+        Serial.println("[LatchDimmer] ERROR: Failed to start timer!");
+        return false;
+    }
+    return true;
+}
+
+void LatchDimmer::end() {
+    // The timer callback checks 'running' under the controller lock,
+    // so no plane is applied after the mask has been cleared
+    controller.beginBatch();
+    if (running) {
+        running = false;
+        esp_timer_stop(timer);
+        controller.clearOutputMask();
+    }
+    controller.commit();
+}
+
+bool LatchDimmer::isRunning() {
+    return running;
+}
+
+void LatchDimmer::timerEntry(void* arg) {
+    static_cast<LatchDimmer*>(arg)->onTimer();
+}
+
+void LatchDimmer::onTimer() {
+    // Runs in the esp_timer task: never wait for the controller lock.
+    // The current plane stays a little longer, the absolute deadlines
+    // resynchronize afterwards.
+    if (!controller.tryBeginBatch()) {
+        if (running) {
+            esp_timer_start_once(timer, LATCH_SERVICE_RETRY_US);
+        }
+        return;
+    }
+
+    if (running) {
+        uint8_t current = plane;
+        LatchState mask;
+        portENTER_CRITICAL(&planeMux);
+        mask = planes[current];
+        portEXIT_CRITICAL(&planeMux);
+        controller.setOutputMask(mask.words, LATCH_STATE_WORDS);
+
+        // Plane b stays visible for 2^b base intervals. Deadlines are
+        // absolute so callback latency does not skew the duty cycle.
+        uint32_t duration = baseUs << current;
+        deadline += duration;
+        plane = (current + 1 < bits) ? current + 1 : 0;
+
+        int64_t delay = deadline - esp_timer_get_time();
+        if (delay < 1) {
+            // Fell behind (e.g. long batch elsewhere): resynchronize
+            delay = duration;
+            deadline = esp_timer_get_time() + delay;
+        }
+        esp_timer_start_once(timer, delay);
+    }
+
+    controller.commit();
+}
+
+void LatchDimmer::renderChannel(uint16_t channel) {
+    uint8_t level = levels[channel];
+    portENTER_CRITICAL(&planeMux);
+    for (uint8_t b = 0; b < bits; b++) {
+        planes[b].set(channel, (level >> b) & 1);
+    }
+    portEXIT_CRITICAL(&planeMux);
+}
+
+bool LatchDimmer::setLevel(uint16_t channel, uint8_t level) {
+    if (channel >= controller.getChannelCount()) {
+        Serial.printf("[LatchDimmer] ERROR: Invalid channel %d\n", channel);
+        return false;
+    }
+    levels[channel] = min(level, getMaxLevel());
+    renderChannel(channel);
+    return true;
+}
+
+void LatchDimmer::setAllLevels(uint8_t level) {
+    for (uint16_t i = 0; i < controller.getChannelCount(); i++) {
+        levels[i] = min(level, getMaxLevel());
+        renderChannel(i);
+    }
+}
+
+uint8_t LatchDimmer::getLevel(uint16_t channel) {
+    if (channel >= controller.getChannelCount()) {
+        return 0;
+    }
+    return levels[channel];
+}
+
+uint8_t LatchDimmer::getMaxLevel() {
+    return (uint8_t)((1U << bits) - 1);
+}
+
+uint32_t LatchDimmer::getFrameRate() {
+    if (baseUs == 0) {
+        return 0;
+    }
+    return 1000000UL / (baseUs * getMaxLevel());
+}
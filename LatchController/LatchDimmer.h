@@ -0,0 +1,128 @@
+/**
+ * @file LatchDimmer.h
+ * @brief Binary code modulation (software PWM) for LatchController outputs
+ * @version 3.0.0
+ * @author MROutake
+ *
+ * Renders per-channel brightness levels into N bitplanes and shows
+ * plane b for 2^b base intervals. A level of 2^N-1 keeps the channel
+ * permanently on, so undimmed channels behave as plain on/off outputs.
+ *
+ * Planes are applied as the controller's output mask from an esp_timer
+ * callback and go through the regular locked update path. They never
+ * change the logical state: a channel lights only while it is ON.
+ *
+ * @code
+ * LatchController leds(&driver, 16);
+ * LatchDimmer dimmer(leds, 6);   // 64 levels
+ *
+ * leds.begin();
+ * dimmer.begin(50);              // 50 us base interval -> ~317 Hz
+ * leds.setAllOn();
+ * dimmer.setLevel(3, 16);
+ * @endcode
+ *
+ * @note Every plane is one driver update. Keep the base interval well
+ *       above the transfer time of the chain.
+ */
+
+#ifndef LATCH_DIMMER_H
+#define LATCH_DIMMER_H
+
+#include "LatchController.h"
+#include "esp_timer.h"
+
+/// Maximum bitplanes (levels are stored as uint8_t)
+#define LATCH_DIMMER_MAX_BITS 8
+
+/**
+ * @class LatchDimmer
+ * @brief Per-channel brightness layer on top of LatchController
+ */
+class LatchDimmer {
+private:
+    LatchController& controller;
+    uint8_t bits;
+    uint8_t levels[LATCH_MAX_CHANNELS];
+    LatchState planes[LATCH_DIMMER_MAX_BITS];
+    portMUX_TYPE planeMux;       ///< Guards planes against the timer callback
+    esp_timer_handle_t timer;
+    uint32_t baseUs;
+    uint8_t plane;               ///< Next plane to show
+    int64_t deadline;            ///< Absolute start time of the next plane
+    bool running;
+
+    void renderChannel(uint16_t channel);
+    void onTimer();
+    static void timerEntry(void* arg);
+
+public:
+    /**
+     * @brief Constructor
+     * @param ctrl Controller whose outputs are dimmed
+     * @param bits Brightness resolution in bits (1 to LATCH_DIMMER_MAX_BITS)
+     */
+    LatchDimmer(LatchController& ctrl, uint8_t bits = 6);
+
+    /**
+     * @brief Destructor - stops modulation
+     */
+    ~LatchDimmer();
+
+    LatchDimmer(const LatchDimmer&) = delete;
+    LatchDimmer& operator=(const LatchDimmer&) = delete;
+
+    /**
+     * @brief Start modulation
+     * @param baseIntervalUs Duration of the least significant plane
+     * @return true on success
+     * @note Call after LatchController::begin()
+     */
+    bool begin(uint32_t baseIntervalUs = 50);
+
+    /**
+     * @brief Stop modulation and return to plain on/off outputs
+     */
+    void end();
+
+    /**
+     * @brief Check if modulation is running
+     * @return true between begin() and end()
+     */
+    bool isRunning();
+
+    /**
+     * @brief Set brightness of a channel
+     * @param channel Channel number
+     * @param level 0 (off) to getMaxLevel() (fully on)
+     * @return true on success
+     */
+    bool setLevel(uint16_t channel, uint8_t level);
+
+    /**
+     * @brief Set brightness of all channels
+     * @param level 0 (off) to getMaxLevel() (fully on)
+     */
+    void setAllLevels(uint8_t level);
+
+    /**
+     * @brief Get brightness of a channel
+     * @param channel Channel number
+     * @return Current level
+     */
+    uint8_t getLevel(uint16_t channel);
+
+    /**
+     * @brief Get highest level (2^bits - 1)
+     * @return Level for fully on
+     */
+    uint8_t getMaxLevel();
+
+    /**
+     * @brief Get modulation frame rate
+     * @return Full BCM cycles per second
+     */
+    uint32_t getFrameRate();
+};
+
+#endif // LATCH_DIMMER_H
@@ -0,0 +1,227 @@
+/**
+ * @file LatchPersistence.cpp
+ * @brief State persistence implementation
+ * @version 3.0.0
+ */
+
+#include "LatchPersistence.h"
+
+LatchPersistence::LatchPersistence(LatchController& ctrl, LatchStore& backend)
+    : controller(ctrl)
+    , store(backend)
+    , records(backend, ctrl.getChannelCount())
+    , quietUs(0)
+    , maxDelayUs(0)
+    , observerId(-1)
+    , task(nullptr)
+    , taskStop(false)
+    , storeLock(nullptr)
+    , pendingSequence(0)
+    , dirty(false)
+    , firstChangeUs(0)
+    , lastChangeUs(0)
+    , writes(0)
+    , failures(0)
+{
+    pending.clear();
+    saved.clear();
+    portMUX_INITIALIZE(&stateMux);
+}
+
+LatchPersistence::~LatchPersistence() {
+    // Returns once no notification is running in onChange()
+    if (observerId >= 0) {
+        controller.unsubscribe(observerId);
+        observerId = -1;
+    }
+    if (storeLock == nullptr) {
+        return;
+    }
+
+    // Writer finishes its current save(), clears task and deletes itself
+    if (task != nullptr) {
+        taskStop = true;
+        xTaskNotifyGive(task);
+        while (task != nullptr) {
+            vTaskDelay(1);
+        }
+    }
+
+    // Flush what is left
+    save();
+    vSemaphoreDelete(storeLock);
+    storeLock = nullptr;
+}
+
+bool LatchPersistence::begin(uint32_t quietMs, uint32_t maxDelayMs) {
+    if (task != nullptr) {
+        return true;
+    }
+    if (controller.isInitialized()) {
+        Serial.println("[LatchPersistence] ERROR: Call begin() before LatchController::begin()!");
+        return false;
+    }
+    if (!store.begin()) {
+        Serial.println("[LatchPersistence] ERROR: Store not available!");
+        return false;
+    }
+
+    if (storeLock == nullptr) {
+        storeLock = xSemaphoreCreateMutex();
+        if (storeLock == nullptr) {
+            Serial.println("[LatchPersistence] ERROR: Failed to create mutex!");
+            return false;
+        }
+    }
+
+    quietUs = quietMs * 1000UL;
+    maxDelayUs = max(maxDelayMs, quietMs) * 1000UL;
+
+    // The controller's first write shows the restored state
+    if (restore()) {
+        controller.setPowerOnState(saved.words, LATCH_STATE_WORDS);
+        Serial.printf("[LatchPersistence] Restored record #%u\n", records.getSequence());
+    }
+    LatchSnapshot snapshot;
+    controller.getSnapshot(snapshot);
+    pending = saved;
+    pendingSequence = snapshot.sequence;
+
+    if (observerId < 0) {
+        observerId = controller.subscribe(onChange, this);
+        if (observerId < 0) {
+            return false;
+        }
+    }
+
+    // Flash writes can stall for milliseconds: keep them off the
+    // committing tasks and the esp_timer task
+    if (xTaskCreatePinnedToCore(taskEntry, "LatchPersist", 3072, this,
+                                1, &task, tskNO_AFFINITY) != pdPASS) {
+        Serial.println("[LatchPersistence] ERROR: Failed to create task!");
+        task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool LatchPersistence::restore() {
+    LatchState state;
+    state.clear();
+    if (!records.restore(state.words)) {
+        return false;
+    }
+    saved = state;
+    saved.limit(controller.getChannelCount());
+    return true;
+}
+
+bool LatchPersistence::save() {
+    if (storeLock == nullptr) {
+        return false;
+    }
+
+    xSemaphoreTake(storeLock, portMAX_DELAY);
+
+    portENTER_CRITICAL(&stateMux);
+    LatchState state = pending;
+    bool changed = dirty;
+    dirty = false;
+    portEXIT_CRITICAL(&stateMux);
+
+    // Toggled back before the write: nothing to do
+    bool ok = true;
+    if (changed && state != saved) {
+        ok = records.append(state.words);
+        if (ok) {
+            saved = state;
+            writes++;
+        } else {
+            // Retry after the quiet time
+            failures++;
+            int64_t now = esp_timer_get_time();
+            portENTER_CRITICAL(&stateMux);
+            if (!dirty) {
+                dirty = true;
+                firstChangeUs = now;
+            }
+            lastChangeUs = now;
+            portEXIT_CRITICAL(&stateMux);
+            Serial.println("[LatchPersistence] ERROR: Store write failed!");
+        }
+    }
+
+    xSemaphoreGive(storeLock);
+    return ok;
+}
+
+bool LatchPersistence::isDirty() {
+    portENTER_CRITICAL(&stateMux);
+    bool result = dirty && pending != saved;
+    portEXIT_CRITICAL(&stateMux);
+    return result;
+}
+
+uint32_t LatchPersistence::getWriteCount() {
+    return writes;
+}
+
+uint32_t LatchPersistence::getFailedWrites() {
+    return failures;
+}
+
+void LatchPersistence::onChange(const LatchChange& change, void* context) {
+    LatchPersistence* self = static_cast<LatchPersistence*>(context);
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&self->stateMux);
+    // Observers run concurrently: never let an older change overwrite
+    // a newer one
+    if ((int32_t)(change.sequence - self->pendingSequence) <= 0) {
+        portEXIT_CRITICAL(&self->stateMux);
+        return;
+    }
+    self->pending = change.newMask;
+    self->pendingSequence = change.sequence;
+    if (!self->dirty) {
+        self->dirty = true;
+        self->firstChangeUs = now;
+    }
+    self->lastChangeUs = now;
+    portEXIT_CRITICAL(&self->stateMux);
+
+    if (self->task != nullptr) {
+        xTaskNotifyGive(self->task);
+    }
+}
+
+void LatchPersistence::taskEntry(void* param) {
+    static_cast<LatchPersistence*>(param)->taskLoop();
+}
+
+void LatchPersistence::taskLoop() {
+    for (;;) {
+        if (taskStop) {
+            task = nullptr;
+            vTaskDelete(nullptr);
+        }
+
+        portENTER_CRITICAL(&stateMux);
+        bool waiting = dirty;
+        int64_t due = min(lastChangeUs + (int64_t)quietUs, firstChangeUs + (int64_t)maxDelayUs);
+        portEXIT_CRITICAL(&stateMux);
+
+        TickType_t wait = portMAX_DELAY;
+        if (waiting) {
+            int64_t left = due - esp_timer_get_time();
+            if (left <= 0) {
+                save();
+                continue;
+            }
+            wait = pdMS_TO_TICKS((left + 999) / 1000) + 1;
+        }
+
+        // Woken early by every change: the deadline moves with it
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
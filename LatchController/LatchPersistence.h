@@ -0,0 +1,116 @@
+/**
+ * @file LatchPersistence.h
+ * @brief Keeps the LatchController state across resets and brownouts
+ * @version 3.0.0
+ * @author MROutake
+ *
+ * Saves the applied state to a LatchStore and restores it in
+ * LatchController::begin(), so the first hardware write after a reset
+ * already shows the saved outputs (no OFF glitch).
+ *
+ * Flash wear is limited twice: changes are coalesced (a record is
+ * written once the state has been quiet for quietMs, at the latest
+ * maxDelayMs after the first unsaved change), and records rotate
+ * through the slots of the store. Unchanged states are never written.
+ *
+ * @code
+ * NvsLatchStore store;                 // #include <NvsLatchStore.h>
+ * LatchPersistence persist(relays, store);
+ *
+ * persist.begin();          // before relays.begin()
+ * relays.begin(ACTIVE_LOW); // outputs come up in the saved state
+ * @endcode
+ *
+ * @note Short pulses (setLatchFor()) ending within quietMs are usually
+ *       not saved. Call save() before a planned power-down.
+ */
+
+#ifndef LATCH_PERSISTENCE_H
+#define LATCH_PERSISTENCE_H
+
+#include "LatchController.h"
+#include "LatchStore.h"
+#include "LatchRecordLog.h"
+
+/**
+ * @class LatchPersistence
+ * @brief Coalescing, wear-leveled state persistence
+ */
+class LatchPersistence {
+private:
+    LatchController& controller;
+    LatchStore& store;
+    LatchRecordLog records;      ///< Encoding and slot rotation
+    uint32_t quietUs;
+    uint32_t maxDelayUs;
+    int8_t observerId;
+    TaskHandle_t task;
+    volatile bool taskStop;      ///< Asks the writer task to exit
+    SemaphoreHandle_t storeLock;   ///< Serializes save() and the task
+    portMUX_TYPE stateMux;       ///< Guards the fields below (observer side)
+    LatchState pending;          ///< Newest applied state
+    uint32_t pendingSequence;    ///< LatchChange::sequence of pending
+    bool dirty;
+    int64_t firstChangeUs;       ///< First change not yet saved
+    int64_t lastChangeUs;
+    LatchState saved;            ///< Content of the newest record
+    uint32_t writes;
+    uint32_t failures;
+
+    bool restore();
+    void taskLoop();
+    static void taskEntry(void* param);
+    static void onChange(const LatchChange& change, void* context);
+
+public:
+    /**
+     * @brief Constructor
+     * @param ctrl Controller to persist
+     * @param store Storage backend (must stay valid)
+     */
+    LatchPersistence(LatchController& ctrl, LatchStore& store);
+
+    /**
+     * @brief Destructor - saves pending changes and stops the writer task
+     */
+    ~LatchPersistence();
+
+    LatchPersistence(const LatchPersistence&) = delete;
+    LatchPersistence& operator=(const LatchPersistence&) = delete;
+
+    /**
+     * @brief Restore the saved state and start saving changes
+     * @param quietMs Write after the state was unchanged this long
+     * @param maxDelayMs Write at the latest this long after a change
+     * @return false if the store cannot be opened
+     * @note Call before LatchController::begin(). Without a valid record
+     *       the controller starts all OFF as usual.
+     */
+    bool begin(uint32_t quietMs = 2000, uint32_t maxDelayMs = 30000);
+
+    /**
+     * @brief Write pending changes now
+     * @return false if the store reported an error
+     */
+    bool save();
+
+    /**
+     * @brief Check if changes wait to be written
+     * @return true while the store lags behind the applied state
+     */
+    bool isDirty();
+
+    /**
+     * @brief Get number of records written
+     * @return Write count since begin()
+     */
+    uint32_t getWriteCount();
+
+    /**
+     * @brief Get number of failed store writes
+     * @return Failure count since begin()
+     */
+    uint32_t getFailedWrites();
+};
+
+#endif // LATCH_PERSISTENCE_H
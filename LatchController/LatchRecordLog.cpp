@@ -0,0 +1,137 @@
+/**
+ * @file LatchRecordLog.cpp
+ * @brief Record log implementation
+ * @version 3.0.0
+ */
+
+#include "LatchRecordLog.h"
+
+/// Record marker ("LATC")
+#define LATCH_RECORD_MAGIC 0x4C415443UL
+
+/// Bytes before the state words
+#define LATCH_RECORD_HEADER 12
+
+LatchRecordLog::LatchRecordLog(LatchStore& backend, uint16_t channelCount)
+    : store(backend)
+    , channels(channelCount)
+    , wordCount((uint8_t)((channelCount + 31) / 32))
+    , sequence(0)
+    , nextSlot(0)
+{
+    recordSize = LATCH_RECORD_HEADER + (size_t)wordCount * 4 + 4;
+    buffer = new uint8_t[recordSize];
+}
+
+LatchRecordLog::~LatchRecordLog() {
+    delete[] buffer;
+}
+
+bool LatchRecordLog::restore(uint32_t* words) {
+    uint8_t slots = store.getSlotCount();
+    bool found = false;
+
+    for (uint8_t w = 0; w < wordCount; w++) {
+        words[w] = 0;
+    }
+    sequence = 0;
+    nextSlot = 0;
+
+    for (uint8_t slot = 0; slot < slots; slot++) {
+        if (!store.readSlot(slot, buffer, recordSize)) {
+            continue;
+        }
+        uint32_t recordSequence;
+        if (!decode(nullptr, recordSequence)) {
+            continue;
+        }
+        // Serial number arithmetic: survives the 32-bit wrap
+        if (found && (int32_t)(recordSequence - sequence) <= 0) {
+            continue;
+        }
+
+        decode(words, recordSequence);
+        found = true;
+        sequence = recordSequence;
+        nextSlot = (slot + 1) % slots;
+    }
+    return found;
+}
+
+bool LatchRecordLog::decode(uint32_t* words, uint32_t& recordSequence) {
+    size_t crcOffset = recordSize - 4;
+    if (get32(buffer) != LATCH_RECORD_MAGIC ||
+        get32(buffer + crcOffset) != crc32(buffer, crcOffset) ||
+        (uint16_t)(buffer[8] | (buffer[9] << 8)) != channels) {
+        return false;
+    }
+
+    recordSequence = get32(buffer + 4);
+    if (words != nullptr) {
+        for (uint8_t w = 0; w < wordCount; w++) {
+            words[w] = get32(buffer + LATCH_RECORD_HEADER + w * 4);
+        }
+    }
+    return true;
+}
+
+bool LatchRecordLog::append(const uint32_t* words) {
+    uint32_t recordSequence = sequence + 1;
+
+    put32(buffer, LATCH_RECORD_MAGIC);
+    put32(buffer + 4, recordSequence);
+    buffer[8] = (uint8_t)channels;
+    buffer[9] = (uint8_t)(channels >> 8);
+    buffer[10] = 0;
+    buffer[11] = 0;
+    for (uint8_t w = 0; w < wordCount; w++) {
+        put32(buffer + LATCH_RECORD_HEADER + w * 4, words[w]);
+    }
+    size_t crcOffset = recordSize - 4;
+    put32(buffer + crcOffset, crc32(buffer, crcOffset));
+
+    if (!store.writeSlot(nextSlot, buffer, recordSize)) {
+        return false;
+    }
+    sequence = recordSequence;
+    nextSlot = (nextSlot + 1) % store.getSlotCount();
+    return true;
+}
+
+uint32_t LatchRecordLog::getSequence() {
+    return sequence;
+}
+
+uint8_t LatchRecordLog::getNextSlot() {
+    return nextSlot;
+}
+
+uint8_t LatchRecordLog::getWordCount() {
+    return wordCount;
+}
+
+size_t LatchRecordLog::getRecordSize() {
+    return recordSize;
+}
+
+uint32_t LatchRecordLog::crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void LatchRecordLog::put32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+uint32_t LatchRecordLog::get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file LatchRecordLog.h
+ * @brief Wear-leveled state records on a LatchStore
+ * @version 3.0.0
+ * @author MROutake
+ *
+ * Encodes channel states as CRC-protected, sequence-numbered records
+ * and writes them round-robin across the slots of a store. restore()
+ * picks the newest record that passes the checks, so a torn or
+ * corrupted slot falls back to the previous one.
+ *
+ * Record layout (little endian, independent of the compiler):
+ *
+ *   magic (4) | sequence (4) | channels (2) | reserved (2) |
+ *   state words (4 each) | CRC-32 of everything before (4)
+ *
+ * Plain C++ without Arduino or ESP-IDF, used by LatchPersistence and
+ * host tests alike.
+ */
+
+#ifndef LATCH_RECORD_LOG_H
+#define LATCH_RECORD_LOG_H
+
+#include "LatchStore.h"
+
+/**
+ * @class LatchRecordLog
+ * @brief Record encoding and slot rotation
+ */
+class LatchRecordLog {
+private:
+    LatchStore& store;
+    uint16_t channels;
+    uint8_t wordCount;
+    size_t recordSize;
+    uint8_t* buffer;         ///< One encoded record
+    uint32_t sequence;       ///< Sequence of the newest record (0 = none)
+    uint8_t nextSlot;
+
+    bool decode(uint32_t* words, uint32_t& recordSequence);
+    static uint32_t crc32(const uint8_t* data, size_t length);
+    static void put32(uint8_t* p, uint32_t value);
+    static uint32_t get32(const uint8_t* p);
+
+public:
+    /**
+     * @brief Constructor
+     * @param store Slot storage (opened by the caller)
+     * @param channels Channel count; records of other counts are ignored
+     */
+    LatchRecordLog(LatchStore& store, uint16_t channels);
+    ~LatchRecordLog();
+
+    LatchRecordLog(const LatchRecordLog&) = delete;
+    LatchRecordLog& operator=(const LatchRecordLog&) = delete;
+
+    /**
+     * @brief Find the newest valid record
+     * @param words Destination, getWordCount() words (all 0 if none)
+     * @return true if a valid record was found
+     * @note Also positions the log: the next append() uses the slot
+     *       after the newest record.
+     */
+    bool restore(uint32_t* words);
+
+    /**
+     * @brief Write a new record to the next slot
+     * @param words State, getWordCount() words
+     * @return false if the store write failed (position is unchanged)
+     */
+    bool append(const uint32_t* words);
+
+    /**
+     * @brief Get sequence number of the newest record
+     * @return Sequence (0 = nothing restored or written yet)
+     */
+    uint32_t getSequence();
+
+    /**
+     * @brief Get slot used by the next append()
+     * @return Slot index
+     */
+    uint8_t getNextSlot();
+
+    /**
+     * @brief Get number of state words per record
+     * @return Words for the configured channel count
+     */
+    uint8_t getWordCount();
+
+    /**
+     * @brief Get size of one encoded record
+     * @return Bytes per slot
+     */
+    size_t getRecordSize();
+};
+
+#endif // LATCH_RECORD_LOG_H
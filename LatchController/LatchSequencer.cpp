@@ -0,0 +1,174 @@
+/**
+ * @file LatchSequencer.cpp
+ * @brief Pattern sequencer implementation
+ * @version 3.0.0
+ */
+
+#include "LatchSequencer.h"
+
+LatchSequencer::LatchSequencer(LatchController& ctrl)
+    : controller(ctrl)
+    , frames(nullptr)
+    , frameCount(0)
+    , frameIndex(0)
+    , loopsLeft(0)
+    , loopCount(0)
+    , overruns(0)
+    , timer(nullptr)
+    , deadline(0)
+    , playing(false)
+{
+}
+
+LatchSequencer::~LatchSequencer() {
+    stop();
+    if (timer != nullptr) {
+        esp_timer_stop(timer);   // a lock retry may have re-armed it
+        esp_timer_delete(timer);
+        timer = nullptr;
+    }
+}
+
+bool LatchSequencer::play(const LatchFrame* sequence, uint16_t count, uint32_t loops) {
+    if (!controller.isInitialized()) {
+        Serial.println("[LatchSequencer] ERROR: Controller not initialized!");
+        return false;
+    }
+    if (sequence == nullptr || count == 0) {
+        Serial.println("[LatchSequencer] ERROR: Empty sequence!");
+        return false;
+    }
+    // A zero dwell would re-arm the timer at once and keep the
+    // esp_timer task busy for a looping sequence
+    for (uint16_t i = 0; i < count; i++) {
+        if (sequence[i].dwellMs == 0) {
+            Serial.println("[LatchSequencer] ERROR: Frame dwell must be at least 1 ms!");
+            return false;
+        }
+    }
+
+    if (timer == nullptr) {
+        esp_timer_create_args_t args = {};
+        args.callback = timerEntry;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "LatchSequencer";
+        if (esp_timer_create(&args, &timer) != ESP_OK) {
+            Serial.println("[LatchSequencer] ERROR: Failed to create timer!");
+            timer = nullptr;
+            return false;
+        }
+    }
+
+    // Same lock as the timer callback: no frame of an old sequence
+    // can slip in after this point
+    controller.beginBatch();
+    // Also when stopped: a lock retry from onTimer() racing with stop()
+    // may have left the timer armed
+    esp_timer_stop(timer);
+
+    frames = sequence;
+    frameCount = count;
+    frameIndex = 0;
+    loopsLeft = loops;
+    loopCount = 0;
+    overruns = 0;
+    playing = true;
+
+    deadline = esp_timer_get_time() + (int64_t)frames[0].dwellMs * 1000;
+    int64_t delay = max((int64_t)1, deadline - esp_timer_get_time());
+    esp_err_t err = esp_timer_start_once(timer, delay);
+    if (err == ESP_ERR_INVALID_STATE) {
+        // Re-armed by a callback that was already running
+        esp_timer_stop(timer);
+        err = esp_timer_start_once(timer, delay);
+    }
+    if (err != ESP_OK) {
+        playing = false;
+        controller.commit();
+        Serial.println("[LatchSequencer] ERROR: Failed to start timer!");
+        return false;
+    }
+    controller.setAllLatches(frames[0].mask);
+
+    controller.commit();
+    return true;
+}
+
+void LatchSequencer::stop() {
+    controller.beginBatch();
+    if (playing) {
+        playing = false;
+        esp_timer_stop(timer);
+    }
+    controller.commit();
+}
+
+bool LatchSequencer::isPlaying() {
+    return playing;
+}
+
+uint16_t LatchSequencer::getFrameIndex() {
+    return frameIndex;
+}
+
+uint32_t LatchSequencer::getLoopCount() {
+    return loopCount;
+}
+
+uint32_t LatchSequencer::getOverruns() {
+    return overruns;
+}
+
+void LatchSequencer::timerEntry(void* arg) {
+    static_cast<LatchSequencer*>(arg)->onTimer();
+}
+
+void LatchSequencer::onTimer() {
+    // Runs in the esp_timer task: never wait for the controller lock.
+    // The frame comes a little late, the absolute timeline catches up.
+    if (!controller.tryBeginBatch()) {
+        if (playing) {
+            esp_timer_start_once(timer, LATCH_SERVICE_RETRY_US);
+        }
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (playing && now < deadline) {
+        // Stale lock-retry tick: keep the frame until its deadline
+        esp_timer_start_once(timer, deadline - now);
+        controller.commit();
+        return;
+    }
+
+    if (playing) {
+        uint16_t next = frameIndex + 1;
+        if (next >= frameCount) {
+            loopCount++;
+            next = 0;
+            if (loopsLeft != 0 && loopCount >= loopsLeft) {
+                // Finished: the last frame stays applied
+                playing = false;
+                controller.commit();
+                return;
+            }
+        }
+        frameIndex = next;
+        controller.setAllLatches(frames[next].mask);
+
+        // Advance on the absolute timeline; only resynchronize after
+        // falling behind by a whole dwell
+        now = esp_timer_get_time();
+        int64_t dwell = (int64_t)frames[next].dwellMs * 1000;
+        deadline += dwell;
+        if (deadline <= now) {
+            overruns++;
+            deadline = now + dwell;
+        }
+        esp_timer_start_once(timer, max((int64_t)1, deadline - now));
+    }
+
+    // One hardware write per frame
+    controller.commit();
+}
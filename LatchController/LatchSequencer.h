@@ -0,0 +1,128 @@
+/**
+ * @file LatchSequencer.h
+ * @brief Timer-driven pattern playback for LatchController
+ * @version 3.0.0
+ * @author MROutake
+ *
+ * Plays an array of (mask, dwell) frames on channels 0-31: chasers,
+ * test sequences, staged start-ups. Frames are scheduled by esp_timer
+ * on absolute deadlines, so callback latency never accumulates into
+ * the sequence timing.
+ *
+ * Each frame is one controller batch: a single hardware write, no
+ * logging, and the write bypasses the coalescing window. The logical
+ * state always shows the current frame.
+ *
+ * Frames go through the regular write path (setAllLatches()):
+ * - Relay protection and inrush staggering still apply, so a frame can
+ *   reach the outputs later or partially. Short dwells and tight
+ *   protection limits do not mix.
+ * - Every frame cancels all pending timed reverts (pulseLatch(),
+ *   setLatchFor()); starting a sequence ends running pulses.
+ * - Every frame replaces the whole state: channels above 31 are OFF
+ *   while a sequence plays.
+ *
+ * @code
+ * static const LatchFrame chaser[] = {   // const: stays in flash
+ *     {0x01, 100}, {0x02, 100}, {0x04, 100}, {0x08, 100}
+ * };
+ *
+ * LatchSequencer sequencer(relays);
+ * sequencer.play(chaser, 4);             // loop forever
+ * ...
+ * sequencer.stop();
+ * @endcode
+ */
+
+#ifndef LATCH_SEQUENCER_H
+#define LATCH_SEQUENCER_H
+
+#include "LatchController.h"
+#include "esp_timer.h"
+
+/**
+ * @struct LatchFrame
+ * @brief One step of a sequence
+ */
+struct LatchFrame {
+    uint32_t mask;      ///< Channel states (bit 0 = channel 0), others OFF
+    uint32_t dwellMs;   ///< Time until the next frame (at least 1)
+};
+
+/**
+ * @class LatchSequencer
+ * @brief Frame player with looping and cancellation
+ */
+class LatchSequencer {
+private:
+    LatchController& controller;
+    const LatchFrame* frames;
+    uint16_t frameCount;
+    uint16_t frameIndex;     ///< Next frame to apply
+    uint32_t loopsLeft;      ///< Remaining passes (0 = forever)
+    uint32_t loopCount;      ///< Completed passes
+    uint32_t overruns;       ///< Frames more than one dwell late
+    esp_timer_handle_t timer;
+    int64_t deadline;        ///< Absolute due time of the next frame
+    bool playing;
+
+    void onTimer();
+    static void timerEntry(void* arg);
+
+public:
+    /**
+     * @brief Constructor
+     * @param ctrl Controller to drive
+     */
+    explicit LatchSequencer(LatchController& ctrl);
+
+    /**
+     * @brief Destructor - stops playback
+     */
+    ~LatchSequencer();
+
+    LatchSequencer(const LatchSequencer&) = delete;
+    LatchSequencer& operator=(const LatchSequencer&) = delete;
+
+    /**
+     * @brief Start playback, replacing a running sequence
+     * @param frames Frame array (must stay valid while playing)
+     * @param count Number of frames
+     * @param loops Number of passes (0 = loop until stop())
+     * @return true on success, false if a frame has dwellMs == 0 or the
+     *         timer cannot be started
+     * @note The last frame stays applied when playback ends
+     */
+    bool play(const LatchFrame* frames, uint16_t count, uint32_t loops = 0);
+
+    /**
+     * @brief Cancel playback (the current frame stays applied)
+     */
+    void stop();
+
+    /**
+     * @brief Check if a sequence is running
+     * @return true until stop() or the last pass has finished
+     */
+    bool isPlaying();
+
+    /**
+     * @brief Get index of the frame currently shown
+     * @return Frame index
+     */
+    uint16_t getFrameIndex();
+
+    /**
+     * @brief Get number of completed passes
+     * @return Loop count since play()
+     */
+    uint32_t getLoopCount();
+
+    /**
+     * @brief Get number of frames applied more than one dwell late
+     * @return Overrun count since play()
+     */
+    uint32_t getOverruns();
+};
+
+#endif // LATCH_SEQUENCER_H
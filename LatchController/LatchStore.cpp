@@ -0,0 +1,51 @@
+/**
+ * @file LatchStore.cpp
+ * @brief File-backed slot storage
+ * @version 3.0.0
+ */
+
+#include "LatchStore.h"
+
+FileLatchStore::FileLatchStore(const char* filePath, uint8_t slotCount)
+    : path(filePath)
+    , slots(slotCount > 0 ? slotCount : 1)
+    , file(nullptr)
+{
+}
+
+FileLatchStore::~FileLatchStore() {
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool FileLatchStore::begin() {
+    if (file != nullptr) {
+        return true;
+    }
+    // Keep existing records, create the file on first use
+    file = fopen(path, "r+b");
+    if (file == nullptr) {
+        file = fopen(path, "w+b");
+    }
+    return file != nullptr;
+}
+
+uint8_t FileLatchStore::getSlotCount() {
+    return slots;
+}
+
+bool FileLatchStore::readSlot(uint8_t slot, void* data, size_t size) {
+    if (file == nullptr || fseek(file, (long)slot * size, SEEK_SET) != 0) {
+        return false;
+    }
+    return fread(data, size, 1, file) == 1;
+}
+
+bool FileLatchStore::writeSlot(uint8_t slot, const void* data, size_t size) {
+    if (file == nullptr || fseek(file, (long)slot * size, SEEK_SET) != 0) {
+        return false;
+    }
+    return fwrite(data, size, 1, file) == 1 && fflush(file) == 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file LatchStore.h
+ * @brief Slot storage interface for LatchPersistence
+ * @version 3.0.0
+ * @author MROutake
+ *
+ * A store offers a small number of fixed-size slots. LatchRecordLog
+ * writes its records round-robin across the slots (wear leveling) and
+ * restores the newest valid one, so a write torn by a brownout falls
+ * back to the previous record.
+ *
+ * - FileLatchStore: one file with all slots (LittleFS/SPIFFS/SD via VFS,
+ *                   or a plain file in host tests)
+ * - NvsLatchStore:  ESP32 NVS partition (NvsLatchStore.h)
+ *
+ * Plain C++: this header and FileLatchStore build without Arduino or
+ * ESP-IDF.
+ */
+
+#ifndef LATCH_STORE_H
+#define LATCH_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ============================================================
+// LatchStore Interface
+// ============================================================
+
+/**
+ * @class LatchStore
+ * @brief Abstract slot storage
+ */
+class LatchStore {
+public:
+    virtual ~LatchStore() {}
+
+    /**
+     * @brief Open the storage
+     * @return true on success
+     */
+    virtual bool begin() = 0;
+
+    /**
+     * @brief Get number of slots used for wear leveling
+     * @return Slot count (at least 1)
+     */
+    virtual uint8_t getSlotCount() = 0;
+
+    /**
+     * @brief Read a slot
+     * @param slot Slot index (0 to getSlotCount()-1)
+     * @param data Destination buffer
+     * @param size Record size in bytes
+     * @return false if the slot is empty or has a different size
+     */
+    virtual bool readSlot(uint8_t slot, void* data, size_t size) = 0;
+
+    /**
+     * @brief Write a slot durably
+     * @param slot Slot index (0 to getSlotCount()-1)
+     * @param data Record
+     * @param size Record size in bytes (the same for every call)
+     * @return true once the data has been committed
+     */
+    virtual bool writeSlot(uint8_t slot, const void* data, size_t size) = 0;
+};
+
+// ============================================================
+// FileLatchStore
+// ============================================================
+
+/**
+ * @class FileLatchStore
+ * @brief Slots at fixed offsets of one file
+ */
+class FileLatchStore : public LatchStore {
+private:
+    const char* path;
+    uint8_t slots;
+    FILE* file;
+
+public:
+    /**
+     * @brief Constructor
+     * @param path File path, e.g. "/littlefs/latch.bin" (must stay valid;
+     *             the file system must be mounted before begin())
+     * @param slots Number of slots to rotate through
+     */
+    FileLatchStore(const char* path, uint8_t slots = 8);
+    ~FileLatchStore();
+
+    FileLatchStore(const FileLatchStore&) = delete;
+    FileLatchStore& operator=(const FileLatchStore&) = delete;
+
+    bool begin() override;
+    uint8_t getSlotCount() override;
+    bool readSlot(uint8_t slot, void* data, size_t size) override;
+    bool writeSlot(uint8_t slot, const void* data, size_t size) override;
+};
+
+#endif // LATCH_STORE_H
@@ -0,0 +1,59 @@
+/**
+ * @file NvsLatchStore.cpp
+ * @brief NVS slot storage implementation
+ * @version 3.0.0
+ */
+
+#include "NvsLatchStore.h"
+
+NvsLatchStore::NvsLatchStore(const char* name, uint8_t slotCount)
+    : ns(name)
+    , slots(max(slotCount, (uint8_t)1))
+    , handle(0)
+    , opened(false)
+{
+}
+
+NvsLatchStore::~NvsLatchStore() {
+    if (opened) {
+        nvs_close(handle);
+        opened = false;
+    }
+}
+
+bool NvsLatchStore::begin() {
+    if (opened) {
+        return true;
+    }
+    // The Arduino core initializes the NVS partition at startup
+    esp_err_t err = nvs_open(ns, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        Serial.printf("[NvsLatchStore] ERROR: nvs_open failed (%d)\n", err);
+        return false;
+    }
+    opened = true;
+    return true;
+}
+
+uint8_t NvsLatchStore::getSlotCount() {
+    return slots;
+}
+
+bool NvsLatchStore::readSlot(uint8_t slot, void* data, size_t size) {
+    if (!opened) {
+        return false;
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "s%u", slot);
+    size_t length = size;
+    return nvs_get_blob(handle, key, data, &length) == ESP_OK && length == size;
+}
+
+bool NvsLatchStore::writeSlot(uint8_t slot, const void* data, size_t size) {
+    if (!opened) {
+        return false;
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "s%u", slot);
+    return nvs_set_blob(handle, key, data, size) == ESP_OK && nvs_commit(handle) == ESP_OK;
+}
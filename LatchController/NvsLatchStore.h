@@ -0,0 +1,45 @@
+/**
+ * @file NvsLatchStore.h
+ * @brief LatchStore backed by the ESP32 NVS partition
+ * @version 3.0.0
+ * @author MROutake
+ */
+
+#ifndef NVS_LATCH_STORE_H
+#define NVS_LATCH_STORE_H
+
+#include <Arduino.h>
+#include "nvs.h"
+#include "LatchStore.h"
+
+/**
+ * @class NvsLatchStore
+ * @brief Slots as blobs in the default NVS partition
+ */
+class NvsLatchStore : public LatchStore {
+private:
+    const char* ns;
+    uint8_t slots;
+    nvs_handle_t handle;
+    bool opened;
+
+public:
+    /**
+     * @brief Constructor
+     * @param ns NVS namespace (max. 15 characters, must stay valid)
+     * @param slots Number of slots (NVS levels its pages itself; 2 slots
+     *              keep the previous record if a write is interrupted)
+     */
+    NvsLatchStore(const char* ns = "latch", uint8_t slots = 2);
+    ~NvsLatchStore();
+
+    NvsLatchStore(const NvsLatchStore&) = delete;
+    NvsLatchStore& operator=(const NvsLatchStore&) = delete;
+
+    bool begin() override;
+    uint8_t getSlotCount() override;
+    bool readSlot(uint8_t slot, void* data, size_t size) override;
+    bool writeSlot(uint8_t slot, const void* data, size_t size) override;
+};
+
+#endif // NVS_LATCH_STORE_H
@@ -0,0 +1,162 @@
+/**
+ * @file CompositeLatchDriver.cpp
+ * @brief Implementierung des Composite-Drivers
+ */
+
+#include "CompositeLatchDriver.h"
+
+CompositeLatchDriver::CompositeLatchDriver()
+    : childCount(0)
+    , totalChannels(0)
+{
+}
+
+bool CompositeLatchDriver::addDriver(LatchDriver* driver, uint16_t channels) {
+    if (driver == nullptr || channels == 0) {
+        Serial.println("[Composite] ERROR: Invalid driver!");
+        return false;
+    }
+    if (childCount >= COMPOSITE_MAX_DRIVERS) {
+        Serial.println("[Composite] ERROR: Too many drivers!");
+        return false;
+    }
+    if (totalChannels + channels > LATCH_MAX_CHANNELS) {
+        Serial.printf("[Composite] ERROR: %d channels exceed LATCH_MAX_CHANNELS (%d)\n",
+                      totalChannels + channels, LATCH_MAX_CHANNELS);
+        return false;
+    }
+
+    Child& child = children[childCount++];
+    child.driver = driver;
+    child.offset = totalChannels;
+    child.channels = channels;
+    child.partial = false;
+    totalChannels += channels;
+    return true;
+}
+
+uint8_t CompositeLatchDriver::getDriverCount() {
+    return childCount;
+}
+
+bool CompositeLatchDriver::init() {
+    if (childCount == 0) {
+        Serial.println("[Composite] ERROR: No drivers attached!");
+        return false;
+    }
+
+    for (uint8_t i = 0; i < childCount; i++) {
+        if (!children[i].driver->init()) {
+            Serial.printf("[Composite] ERROR: Init of %s failed!\n", children[i].driver->getName());
+            return false;
+        }
+        children[i].partial = children[i].driver->supportsPartialUpdate();
+    }
+
+    Serial.printf("[Composite] Initialized: %d drivers, %d channels\n", childCount, totalChannels);
+    for (uint8_t i = 0; i < childCount; i++) {
+        Serial.printf("  %d-%d: %s\n", children[i].offset,
+                      children[i].offset + children[i].channels - 1, children[i].driver->getName());
+    }
+    return true;
+}
+
+bool CompositeLatchDriver::extractSlice(const uint32_t* src, uint16_t offset, uint16_t count,
+                                        uint32_t* dst) {
+    // Bits offset bis offset+count-1 nach dst ab Bit 0 kopieren
+    uint32_t any = 0;
+    uint8_t shift = offset & 31;
+    for (uint8_t w = 0; w < LATCH_WORD_COUNT(count); w++) {
+        uint16_t srcWord = (offset >> 5) + w;
+        uint32_t value = src[srcWord] >> shift;
+        if (shift != 0 && srcWord + 1 < LATCH_STATE_WORDS) {
+            value |= src[srcWord + 1] << (32 - shift);
+        }
+        value &= LatchState::wordMask(w, count);
+        dst[w] = value;
+        any |= value;
+    }
+    return any != 0;
+}
+
+void CompositeLatchDriver::writeChild(const Child& child, const uint32_t* data,
+                                      const uint32_t* changed, uint16_t channelCount) {
+    // Bereich auf die vom Controller genutzten Kanäle begrenzen
+    if (child.offset >= channelCount) {
+        return;
+    }
+    uint16_t count = channelCount - child.offset;
+    if (count > child.channels) {
+        count = child.channels;
+    }
+
+    uint32_t changedSlice[LATCH_STATE_WORDS];
+    if (changed != nullptr && !extractSlice(changed, child.offset, count, changedSlice)) {
+        return;   // Ausschnitt unverändert: kein Bustransfer
+    }
+
+    uint32_t slice[LATCH_STATE_WORDS];
+    extractSlice(data, child.offset, count, slice);
+
+    if (changed != nullptr && child.partial) {
+        child.driver->updateChannels(slice, changedSlice, count);
+    } else {
+        child.driver->updateHardwareWords(slice, count);
+    }
+}
+
+void CompositeLatchDriver::updateHardware(uint32_t data, uint8_t channelCount) {
+    // Auf volle Breite erweitern (extractSlice liest Folgewörter)
+    LatchState words;
+    words.clear();
+    words.words[0] = data;
+    updateHardwareWords(words.words, channelCount);
+}
+
+void CompositeLatchDriver::updateHardwareWords(const uint32_t* data, uint16_t channelCount) {
+    // Vollständiges Update (erster Schreibzugriff, refresh()): alle Kinder
+    for (uint8_t i = 0; i < childCount; i++) {
+        writeChild(children[i], data, nullptr, channelCount);
+    }
+}
+
+bool CompositeLatchDriver::supportsPartialUpdate() {
+    return true;
+}
+
+void CompositeLatchDriver::updateChannels(const uint32_t* data, const uint32_t* changedMask,
+                                          uint16_t channelCount) {
+    for (uint8_t i = 0; i < childCount; i++) {
+        writeChild(children[i], data, changedMask, channelCount);
+    }
+}
+
+bool CompositeLatchDriver::supportsBrightness() {
+    for (uint8_t i = 0; i < childCount; i++) {
+        if (children[i].driver->supportsBrightness()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CompositeLatchDriver::setBrightness(uint8_t level) {
+    for (uint8_t i = 0; i < childCount; i++) {
+        if (children[i].driver->supportsBrightness()) {
+            children[i].driver->setBrightness(level);
+        }
+    }
+}
+
+const char* CompositeLatchDriver::getName() {
+    return "Composite";
+}
+
+uint8_t CompositeLatchDriver::getMaxChannels() {
+    uint16_t capacity = getChannelCapacity();
+    return (capacity > 255) ? 255 : (uint8_t)capacity;
+}
+
+uint16_t CompositeLatchDriver::getChannelCapacity() {
+    return totalChannels;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file CompositeLatchDriver.h
+ * @brief Driver, der mehrere LatchDriver zu einem Kanalraum zusammenfasst
+ *
+ * Beispiel: Schaltschrank mit 74HC595-Kette und 74HC373-Bank an einem
+ * einzigen LatchController (ein Zustand, ein Mutex, eine API).
+ *
+ * Aufteilung:
+ * - Jeder Kind-Driver übernimmt einen zusammenhängenden Kanalbereich,
+ *   in der Reihenfolge der addDriver()-Aufrufe
+ * - Kind-Driver sehen ihre Kanäle ab 0 (Bit 0 = erster Kanal des Bereichs)
+ *
+ * Schreibzugriffe:
+ * - Nur Kind-Driver, deren Ausschnitt sich geändert hat, werden
+ *   aktualisiert (Partial Update des LatchControllers)
+ * - Kind-Driver mit eigenem Partial Update bekommen ihre geänderten Bits
+ * - refresh() und der erste Schreibzugriff aktualisieren alle Kind-Driver
+ *
+ * @code
+ * ShiftRegisterDriver chain(23, 18, 19);
+ * DirectLatchDriver bank(bankPins, 21, 8);
+ * CompositeLatchDriver cabinet;
+ * cabinet.addDriver(&chain, 32);   // Kanäle 0-31
+ * cabinet.addDriver(&bank, 8);     // Kanäle 32-39
+ *
+ * LatchController outputs(&cabinet, 40);   // LATCH_MAX_CHANNELS >= 40
+ * @endcode
+ *
+ * @note Kind-Driver werden synchron beschrieben (kein submit()).
+ */
+
+#ifndef COMPOSITE_LATCH_DRIVER_H
+#define COMPOSITE_LATCH_DRIVER_H
+
+#include "LatchController.h"
+
+/// Maximale Anzahl Kind-Driver
+#ifndef COMPOSITE_MAX_DRIVERS
+#define COMPOSITE_MAX_DRIVERS 4
+#endif
+
+/**
+ * @class CompositeLatchDriver
+ * @brief Verteilt einen Kanalraum auf mehrere Kind-Driver
+ */
+class CompositeLatchDriver : public LatchDriver {
+private:
+    struct Child {
+        LatchDriver* driver;
+        uint16_t offset;      // Erster Kanal im Gesamtraum
+        uint16_t channels;    // Anzahl Kanäle des Bereichs
+        bool partial;         // Kind unterstützt updateChannels()
+    };
+
+    Child children[COMPOSITE_MAX_DRIVERS];
+    uint8_t childCount;
+    uint16_t totalChannels;
+
+    void writeChild(const Child& child, const uint32_t* data, const uint32_t* changed,
+                    uint16_t channelCount);
+    static bool extractSlice(const uint32_t* src, uint16_t offset, uint16_t count, uint32_t* dst);
+
+public:
+    CompositeLatchDriver();
+
+    /**
+     * @brief Kind-Driver für die nächsten Kanäle anhängen
+     * @param driver Kind-Driver (muss gültig bleiben)
+     * @param channels Anzahl Kanäle des Bereichs
+     * @return false wenn alle Plätze belegt sind oder LATCH_MAX_CHANNELS
+     *         überschritten wird
+     * @note Vor LatchController::begin() aufrufen
+     */
+    bool addDriver(LatchDriver* driver, uint16_t channels);
+
+    /**
+     * @brief Anzahl angehängter Kind-Driver
+     * @return Kind-Driver
+     */
+    uint8_t getDriverCount();
+
+    bool init() override;
+    void updateHardware(uint32_t data, uint8_t channelCount) override;
+    void updateHardwareWords(const uint32_t* data, uint16_t channelCount) override;
+    bool supportsPartialUpdate() override;
+    void updateChannels(const uint32_t* data, const uint32_t* changedMask, uint16_t channelCount) override;
+    bool supportsBrightness() override;
+    void setBrightness(uint8_t level) override;
+    const char* getName() override;
+    uint8_t getMaxChannels() override;
+    uint16_t getChannelCapacity() override;
+};
+
+#endif // COMPOSITE_LATCH_DRIVER_H
@@ -5,30 +5,37 @@
 
 #include "DirectLatchDriver.h"
 
-DirectLatchDriver::DirectLatchDriver(uint8_t* pins, uint8_t enable, uint8_t channels) {
+DirectLatchDriver::DirectLatchDriver(uint8_t* pins, uint8_t enable, uint8_t channels, uint8_t pulseUs) {
     numChannels = channels;
     enablePin = enable;
+    enablePulseUs = pulseUs;
     
     // Pins kopieren
     dataPins = new uint8_t[channels];
+    dataOut = new FastPin[channels];
     for (uint8_t i = 0; i < channels; i++) {
         dataPins[i] = pins[i];
+        dataOut[i].attach(0xFF);
     }
+    enableOut.attach(0xFF);
 }
 
 DirectLatchDriver::~DirectLatchDriver() {
     delete[] dataPins;
+    delete[] dataOut;
 }
 
 bool DirectLatchDriver::init() {
     // Enable-Pin konfigurieren
     pinMode(enablePin, OUTPUT);
     digitalWrite(enablePin, LOW);  // Erstmal LOW (Latches halten)
+    enableOut.attach(enablePin);
     
     // Data-Pins konfigurieren
     for (uint8_t i = 0; i < numChannels; i++) {
         pinMode(dataPins[i], OUTPUT);
         digitalWrite(dataPins[i], LOW);
+        dataOut[i].attach(dataPins[i]);
     }
     
     Serial.printf("✓ DirectLatchDriver initialisiert (74HC373-Style)\n");
@@ -39,16 +46,54 @@ bool DirectLatchDriver::init() {
 }
 
 void DirectLatchDriver::updateHardware(uint32_t data, uint8_t channelCount) {
-    // 1. Enable HIGH → Latches transparent
-    digitalWrite(enablePin, HIGH);
-    
-    // 2. Data-Pins setzen
+    // 1. Set-/Clear-Masken für den ganzen Datenbus vorberechnen
+    FastPinSet bus;
+    bus.reset();
     for (uint8_t i = 0; i < channelCount && i < numChannels; i++) {
-        digitalWrite(dataPins[i], (data & (1UL << i)) ? HIGH : LOW);
+        bus.add(dataOut[i], (data & (1UL << i)) != 0);
     }
     
-    // 3. Enable LOW → Werte speichern
-    digitalWrite(enablePin, LOW);
+    // 2. Alle Data-Pins gleichzeitig setzen (ein W1TS + ein W1TC)
+    bus.apply();
+    
+    // 3. Enable-Puls → Latches kurz transparent, dann Werte speichern
+    pulseEnable();
+}
+
+bool DirectLatchDriver::supportsPartialUpdate() {
+    return true;
+}
+
+void DirectLatchDriver::updateChannels(const uint32_t* data, const uint32_t* changedMask, uint16_t channelCount) {
+    // Nur geänderte Data-Pins anfassen
+    uint32_t limit = (channelCount < numChannels) ? channelCount : numChannels;
+    uint32_t changed = changedMask[0];
+    if (limit < 32) {
+        changed &= (1UL << limit) - 1;
+    }
+    if (changed == 0) {
+        return;
+    }
+
+    FastPinSet bus;
+    bus.reset();
+    while (changed != 0) {
+        uint8_t i = __builtin_ctz(changed);
+        bus.add(dataOut[i], (data[0] & (1UL << i)) != 0);
+        changed &= changed - 1;
+    }
+    bus.apply();
+
+    // Enable-Puls: unveränderte Pins liegen noch mit altem Wert an
+    pulseEnable();
+}
+
+void DirectLatchDriver::pulseEnable() {
+    enableOut.high();
+    if (enablePulseUs > 0) {
+        delayMicroseconds(enablePulseUs);
+    }
+    enableOut.low();
 }
 
 const char* DirectLatchDriver::getName() {
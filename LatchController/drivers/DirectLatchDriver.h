@@ -12,12 +12,19 @@
  * - Ein gemeinsames ENABLE-Signal
  * - EN=HIGH → Ausgänge folgen Eingängen
  * - EN=LOW → Ausgänge halten Wert
+ * 
+ * Alle DATA-Pins werden mit einem Schreibzugriff auf W1TS und einem auf
+ * W1TC gleichzeitig gesetzt, danach wird ENABLE gepulst. Der Puls ist
+ * mindestens pulseUs lang: zwei Registerzugriffe direkt hintereinander
+ * ergäben nur wenige 10 ns, weniger als die minimale Enable-Pulsbreite
+ * von '373/'573-Latches bei 3,3 V.
  */
 
 #ifndef DIRECT_LATCH_DRIVER_H
 #define DIRECT_LATCH_DRIVER_H
 
 #include "../LatchController.h"
+#include "FastGpio.h"
 
 /**
  * @class DirectLatchDriver
@@ -28,6 +35,11 @@ private:
     uint8_t* dataPins;      // Array mit DATA-Pins für jeden Kanal
     uint8_t enablePin;      // Gemeinsamer Enable-Pin
     uint8_t numChannels;    // Anzahl Kanäle
+    FastPin* dataOut;       // Vorberechnete Register der DATA-Pins
+    FastPin enableOut;      // Vorberechnetes Register des Enable-Pins
+    uint8_t enablePulseUs;  // Mindestbreite des Enable-Pulses
+
+    void pulseEnable();
 
 public:
     /**
@@ -35,12 +47,15 @@ public:
      * @param pins Array mit GPIO-Pins für D0-D7
      * @param enable Enable-Pin
      * @param channels Anzahl Kanäle
+     * @param pulseUs Mindestbreite des Enable-Pulses in µs (0 = so kurz wie möglich)
      */
-    DirectLatchDriver(uint8_t* pins, uint8_t enable, uint8_t channels);
+    DirectLatchDriver(uint8_t* pins, uint8_t enable, uint8_t channels, uint8_t pulseUs = 1);
     ~DirectLatchDriver();
 
     bool init() override;
     void updateHardware(uint32_t data, uint8_t channelCount) override;
+    bool supportsPartialUpdate() override;
+    void updateChannels(const uint32_t* data, const uint32_t* changedMask, uint16_t channelCount) override;
     const char* getName() override;
     uint8_t getMaxChannels() override;
 };
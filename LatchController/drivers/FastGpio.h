@@ -0,0 +1,110 @@
+/**
+ * @file FastGpio.h
+ * @brief Direkter GPIO-Registerzugriff für Bit-Bang-Treiber
+ *
+ * digitalWrite() sucht bei jedem Aufruf Pin und Bank und prüft Grenzen.
+ * FastPin berechnet Register und Bitmaske einmalig in init() und setzt
+ * den Pin danach mit einem einzigen Schreibzugriff auf
+ * GPIO_OUT_W1TS (setzen) bzw. GPIO_OUT_W1TC (löschen).
+ *
+ * - Pins 0-31:  Bank 0 (out_w1ts / out_w1tc)
+ * - Pins 32-39: Bank 1 (out1_w1ts / out1_w1tc)
+ *
+ * FastPinSet sammelt mehrere Pins und schreibt sie mit je einem
+ * Zugriff auf W1TS und W1TC pro Bank (parallele Busse).
+ *
+ * Der Pin muss vorher per pinMode(pin, OUTPUT) konfiguriert sein.
+ */
+
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <Arduino.h>
+#include "soc/soc.h"
+#include "soc/soc_caps.h"
+#include "soc/gpio_reg.h"
+
+/**
+ * @struct FastPin
+ * @brief Vorberechneter Ausgangspin (auch im Interrupt-Kontext nutzbar)
+ */
+struct FastPin {
+    uint32_t setReg;     // W1TS-Register der Bank
+    uint32_t clearReg;   // W1TC-Register der Bank
+    uint32_t mask;       // Bit des Pins (0 = nicht verwendet)
+
+    /**
+     * @brief Register und Maske für einen Pin berechnen
+     * @param pin GPIO-Nummer (0xFF = nicht verwendet, Schreibzugriffe wirkungslos)
+     */
+    void attach(uint8_t pin) {
+        setReg = GPIO_OUT_W1TS_REG;
+        clearReg = GPIO_OUT_W1TC_REG;
+        mask = 0;
+        if (pin == 0xFF) {
+            return;
+        }
+#if SOC_GPIO_PIN_COUNT > 32
+        if (pin >= 32) {
+            setReg = GPIO_OUT1_W1TS_REG;
+            clearReg = GPIO_OUT1_W1TC_REG;
+        }
+#endif
+        mask = BIT(pin & 31);
+    }
+
+    inline void high() const {
+        REG_WRITE(setReg, mask);
+    }
+
+    inline void low() const {
+        REG_WRITE(clearReg, mask);
+    }
+
+    inline void write(bool level) const {
+        REG_WRITE(level ? setReg : clearReg, mask);
+    }
+
+    /// true für Pins in Bank 1 (GPIO 32+)
+    inline bool isHighBank() const {
+        return setReg != GPIO_OUT_W1TS_REG;
+    }
+};
+
+/**
+ * @struct FastPinSet
+ * @brief Sammelt Pegel mehrerer Pins für einen gemeinsamen Schreibzugriff
+ */
+struct FastPinSet {
+    uint32_t setMask[2];     // [Bank 0, Bank 1]
+    uint32_t clearMask[2];
+
+    inline void reset() {
+        setMask[0] = setMask[1] = 0;
+        clearMask[0] = clearMask[1] = 0;
+    }
+
+    /// Pin mit gewünschtem Pegel aufnehmen
+    inline void add(const FastPin& pin, bool level) {
+        uint8_t bank = pin.isHighBank() ? 1 : 0;
+        if (level) {
+            setMask[bank] |= pin.mask;
+        } else {
+            clearMask[bank] |= pin.mask;
+        }
+    }
+
+    /// Alle gesammelten Pins setzen/löschen (ein W1TS + ein W1TC je Bank)
+    inline void apply() const {
+        REG_WRITE(GPIO_OUT_W1TS_REG, setMask[0]);
+        REG_WRITE(GPIO_OUT_W1TC_REG, clearMask[0]);
+#if SOC_GPIO_PIN_COUNT > 32
+        if ((setMask[1] | clearMask[1]) != 0) {
+            REG_WRITE(GPIO_OUT1_W1TS_REG, setMask[1]);
+            REG_WRITE(GPIO_OUT1_W1TC_REG, clearMask[1]);
+        }
+#endif
+    }
+};
+
+#endif // FAST_GPIO_H
@@ -0,0 +1,452 @@
+/**
+ * @file I2SRefreshDriver.cpp
+ * @brief Implementierung des I2S-Refresh-Drivers
+ */
+
+#include "I2SRefreshDriver.h"
+#include "esp_heap_caps.h"
+
+#if CONFIG_IDF_TARGET_ESP32
+#include "soc/i2s_struct.h"
+#include "soc/gpio_sig_map.h"
+#include "soc/periph_defs.h"
+#include "rom/lldesc.h"
+#include "esp_rom_gpio.h"
+#include "driver/gpio.h"
+#if __has_include("esp_private/periph_ctrl.h")
+#include "esp_private/periph_ctrl.h"
+#else
+#include "driver/periph_ctrl.h"
+#endif
+#endif
+
+// Maximale Länge eines DMA-Deskriptors (12 Bit, durch 4 teilbar)
+#define I2S_REFRESH_DESC_MAX 4092
+
+// Reserve für Interrupt-Latenz beim Warten auf den Pufferwechsel
+#define I2S_REFRESH_SWAP_MARGIN_US 50
+
+// Konstruktor für eine Kette
+I2SRefreshDriver::I2SRefreshDriver(uint8_t data, uint8_t clock, uint8_t latch,
+                                   uint32_t clockHz, uint16_t maxFrames)
+    : I2SRefreshDriver(&data, 1, clock, latch, clockHz, maxFrames) {
+}
+
+// Konstruktor für parallele Ketten
+I2SRefreshDriver::I2SRefreshDriver(const uint8_t* dataPins, uint8_t chains, uint8_t clock,
+                                   uint8_t latch, uint32_t clockHz, uint16_t maxFrames) {
+    chainCount = (chains < 1) ? 1 : ((chains > I2S_REFRESH_MAX_CHAINS) ? I2S_REFRESH_MAX_CHAINS : chains);
+    for (uint8_t c = 0; c < chainCount; c++) {
+        chainPins[c] = dataPins[c];
+    }
+    clockPin = clock;
+    latchPin = latch;
+    this->clockHz = clockHz;
+    this->maxFrames = (maxFrames < 1) ? 1 : maxFrames;
+    buffers[0] = buffers[1] = nullptr;
+    descriptors[0] = descriptors[1] = nullptr;
+    descriptorCount[0] = descriptorCount[1] = 0;
+    maxDescriptors = 0;
+    bufferSize = 0;
+    front = 0;
+    swapPending = false;
+    swapDesc = 0;
+    swapTimeoutUs = 0;
+    swapSignal = xSemaphoreCreateBinaryStatic(&swapSignalBuffer);
+    eofInterrupt = nullptr;
+    configured = false;
+    running = false;
+}
+
+I2SRefreshDriver::~I2SRefreshDriver() {
+    stop();
+    vSemaphoreDelete(swapSignal);
+    for (uint8_t b = 0; b < 2; b++) {
+        if (buffers[b] != nullptr) {
+            heap_caps_free(buffers[b]);
+        }
+        if (descriptors[b] != nullptr) {
+            heap_caps_free(descriptors[b]);
+        }
+    }
+}
+
+uint16_t I2SRefreshDriver::frameSamples(uint16_t channelCount) const {
+    // L Datenbits + 1 Latch-Sample, auf 32 Bit (2 Samples) aufgerundet
+    uint16_t length = (channelCount + chainCount - 1) / chainCount;
+    return (length + 2) & ~1;
+}
+
+bool I2SRefreshDriver::init() {
+#if CONFIG_IDF_TARGET_ESP32
+    if (configured) {
+        return true;
+    }
+
+    bufferSize = (uint32_t)maxFrames * frameSamples(LATCH_MAX_CHANNELS) * 2;
+    maxDescriptors = (bufferSize + I2S_REFRESH_DESC_MAX - 1) / I2S_REFRESH_DESC_MAX;
+
+    // Größen hängen nur vom Konstruktor ab: Puffer eines
+    // fehlgeschlagenen init() werden wiederverwendet
+    for (uint8_t b = 0; b < 2; b++) {
+        if (buffers[b] == nullptr) {
+            buffers[b] = (uint16_t*)heap_caps_malloc(bufferSize, MALLOC_CAP_DMA);
+        }
+        if (descriptors[b] == nullptr) {
+            descriptors[b] = (lldesc_t*)heap_caps_malloc(maxDescriptors * sizeof(lldesc_t), MALLOC_CAP_DMA);
+        }
+        if (buffers[b] == nullptr || descriptors[b] == nullptr) {
+            Serial.println("[I2SRefresh] ERROR: DMA buffer allocation failed!");
+            return false;
+        }
+    }
+
+    if (!initPeripheral()) {
+        return false;
+    }
+
+    // EOF-Interrupt meldet den Pufferwechsel, aktiv nur während eines Wechsels
+    if (eofInterrupt == nullptr &&
+        esp_intr_alloc(ETS_I2S1_INTR_SOURCE, ESP_INTR_FLAG_IRAM, eofIsr, this, &eofInterrupt) != ESP_OK) {
+        Serial.println("[I2SRefresh] ERROR: EOF interrupt allocation failed!");
+        eofInterrupt = nullptr;
+        return false;
+    }
+
+    // Nach dem Umhängen: Rest des alten Rings plus ein Durchlauf des
+    // neuen, beide höchstens einen vollen Puffer lang
+    swapTimeoutUs = (uint32_t)((uint64_t)bufferSize * 1000000ULL / clockHz) + I2S_REFRESH_SWAP_MARGIN_US;
+
+    // Der DMA startet erst mit dem ersten Frame: ein Startframe mit
+    // allen Bits 0 würde ACTIVE_LOW-Lasten einschalten
+    front = 0;
+    swapPending = false;
+    configured = true;
+
+    Serial.printf("[I2SRefresh] Initialized: %s\n", getName());
+    Serial.printf("  DATA=%d", chainPins[0]);
+    for (uint8_t c = 1; c < chainCount; c++) {
+        Serial.printf("/%d", chainPins[c]);
+    }
+    Serial.printf(", CLOCK=%d, LATCH=%d, %u kHz, %u frame(s)\n",
+                  clockPin, latchPin, clockHz / 1000, maxFrames);
+    return true;
+#else
+    Serial.println("[I2SRefresh] ERROR: I2S parallel mode requires ESP32!");
+    return false;
+#endif
+}
+
+bool I2SRefreshDriver::initPeripheral() {
+#if CONFIG_IDF_TARGET_ESP32
+    periph_module_reset(PERIPH_I2S1_MODULE);
+    periph_module_enable(PERIPH_I2S1_MODULE);
+
+    // Pins über die GPIO-Matrix auf den 16-Bit-Bus legen (Daten ab OUT8)
+    for (uint8_t c = 0; c <= chainCount; c++) {
+        uint8_t pin = (c < chainCount) ? chainPins[c] : latchPin;
+        esp_rom_gpio_pad_select_gpio(pin);
+        gpio_set_direction((gpio_num_t)pin, GPIO_MODE_OUTPUT);
+        esp_rom_gpio_connect_out_signal(pin, I2S1O_DATA_OUT8_IDX + c, false, false);
+    }
+    // Daten wechseln mit der steigenden WS-Flanke → invertiert, damit
+    // SHCP in der Mitte des Samples steigt
+    esp_rom_gpio_pad_select_gpio(clockPin);
+    gpio_set_direction((gpio_num_t)clockPin, GPIO_MODE_OUTPUT);
+    esp_rom_gpio_connect_out_signal(clockPin, I2S1O_WS_OUT_IDX, true, false);
+
+    i2s_dev_t* dev = &I2S1;
+
+    // Reset von Sender, FIFO und DMA
+    dev->conf.tx_reset = 1;
+    dev->conf.tx_reset = 0;
+    dev->conf.tx_fifo_reset = 1;
+    dev->conf.tx_fifo_reset = 0;
+    dev->lc_conf.out_rst = 1;
+    dev->lc_conf.out_rst = 0;
+    dev->lc_conf.ahbm_rst = 1;
+    dev->lc_conf.ahbm_rst = 0;
+    dev->lc_conf.ahbm_fifo_rst = 1;
+    dev->lc_conf.ahbm_fifo_rst = 0;
+
+    // LCD-Modus, 16 Bit pro Sample, ein Kanal
+    dev->conf2.val = 0;
+    dev->conf2.lcd_en = 1;
+    dev->sample_rate_conf.val = 0;
+    dev->sample_rate_conf.tx_bits_mod = 16;
+    dev->sample_rate_conf.tx_bck_div_num = 2;
+
+    // Takt: PLL_D2 (160 MHz) / clkm_div_num / 2
+    uint32_t divider = 80000000UL / clockHz;
+    if (divider < 2) divider = 2;
+    if (divider > 255) divider = 255;
+    dev->clkm_conf.val = 0;
+    dev->clkm_conf.clka_en = 0;
+    dev->clkm_conf.clkm_div_a = 1;
+    dev->clkm_conf.clkm_div_b = 0;
+    dev->clkm_conf.clkm_div_num = divider;
+    clockHz = 80000000UL / divider;
+
+    dev->fifo_conf.val = 0;
+    dev->fifo_conf.tx_fifo_mod_force_en = 1;
+    dev->fifo_conf.tx_fifo_mod = 1;
+    dev->fifo_conf.tx_data_num = 32;
+    dev->fifo_conf.dscr_en = 1;
+
+    dev->conf1.val = 0;
+    dev->conf1.tx_stop_en = 0;
+    dev->conf1.tx_pcm_bypass = 1;
+
+    dev->conf_chan.val = 0;
+    dev->conf_chan.tx_chan_mod = 1;
+    dev->timing.val = 0;
+
+    // EOF-Interrupt erst beim Pufferwechsel freigeben (swapIn())
+    dev->int_ena.val = 0;
+    dev->int_clr.val = 0xFFFFFFFF;
+    dev->lc_conf.val = 0;
+    dev->lc_conf.out_eof_mode = 1;
+    dev->lc_conf.outdscr_burst_en = 1;
+    dev->lc_conf.out_data_burst_en = 1;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void I2SRefreshDriver::start() {
+#if CONFIG_IDF_TARGET_ESP32
+    I2S1.out_link.addr = (uint32_t)(uintptr_t)&descriptors[front][0];
+    I2S1.out_link.start = 1;
+    I2S1.conf.tx_start = 1;
+    running = true;
+#endif
+}
+
+void I2SRefreshDriver::stop() {
+#if CONFIG_IDF_TARGET_ESP32
+    if (!configured) {
+        return;
+    }
+    I2S1.int_ena.val = 0;
+    I2S1.conf.tx_start = 0;
+    I2S1.out_link.stop = 1;
+    if (eofInterrupt != nullptr) {
+        esp_intr_free(eofInterrupt);
+        eofInterrupt = nullptr;
+    }
+    periph_module_disable(PERIPH_I2S1_MODULE);
+    swapPending = false;
+    running = false;
+    configured = false;
+#endif
+}
+
+void I2SRefreshDriver::renderFrame(uint16_t* samples, const uint32_t* data, uint16_t channelCount) {
+    uint16_t length = (channelCount + chainCount - 1) / chainCount;
+    uint16_t count = frameSamples(channelCount);
+    uint16_t latchBit = 1 << chainCount;
+
+    // Der FIFO gibt die beiden 16-Bit-Hälften eines Worts vertauscht aus
+    // → Sample j liegt an Position j ^ 1
+    for (uint16_t j = 0; j < count; j++) {
+        uint16_t sample = 0;
+        if (j < length) {
+            // Höchster Kanal jeder Kette zuerst (MSB-First)
+            uint16_t offset = length - 1 - j;
+            for (uint8_t c = 0; c < chainCount; c++) {
+                uint16_t channel = c * length + offset;
+                if (channel < channelCount && (data[channel >> 5] & (1UL << (channel & 31)))) {
+                    sample |= 1 << c;
+                }
+            }
+        } else if (j == length) {
+            sample = latchBit;   // STCP HIGH → Daten übernehmen
+        }
+        samples[j ^ 1] = sample;
+    }
+}
+
+void I2SRefreshDriver::linkDescriptors(uint8_t index, uint32_t bytes) {
+#if CONFIG_IDF_TARGET_ESP32
+    lldesc_t* desc = descriptors[index];
+    const uint8_t* base = (const uint8_t*)buffers[index];
+    uint16_t count = (bytes + I2S_REFRESH_DESC_MAX - 1) / I2S_REFRESH_DESC_MAX;
+
+    for (uint16_t k = 0; k < count; k++) {
+        uint32_t offset = (uint32_t)k * I2S_REFRESH_DESC_MAX;
+        uint32_t chunk = bytes - offset;
+        if (chunk > I2S_REFRESH_DESC_MAX) chunk = I2S_REFRESH_DESC_MAX;
+
+        desc[k].size = chunk;
+        desc[k].length = chunk;
+        desc[k].offset = 0;
+        desc[k].sosf = 0;
+        desc[k].eof = (k == count - 1);   // Markiert das Ende eines Durchlaufs
+        desc[k].owner = 1;
+        desc[k].buf = base + offset;
+        // Letzter Deskriptor zeigt auf den ersten → Endlosschleife
+        desc[k].qe.stqe_next = &desc[(k + 1 < count) ? k + 1 : 0];
+    }
+    descriptorCount[index] = count;
+#else
+    (void)index;
+    (void)bytes;
+#endif
+}
+
+void I2SRefreshDriver::swapIn(const uint32_t* frames, uint16_t frameCount, uint16_t channelCount) {
+#if CONFIG_IDF_TARGET_ESP32
+    uint16_t samples = frameSamples(channelCount);
+    uint8_t words = LATCH_WORD_COUNT(channelCount);
+    uint8_t back = front ^ 1;
+
+    for (uint16_t f = 0; f < frameCount; f++) {
+        renderFrame(buffers[back] + (uint32_t)f * samples, frames + (uint32_t)f * words, channelCount);
+    }
+    linkDescriptors(back, (uint32_t)frameCount * samples * 2);
+
+    // Interrupt vor dem Umhängen freigeben, damit das EOF des neuen
+    // Rings nicht verpasst wird; EOFs des alten Rings ignoriert die ISR
+    swapDesc = (uint32_t)(uintptr_t)&descriptors[back][descriptorCount[back] - 1];
+    swapPending = true;
+    I2S1.int_clr.out_eof = 1;
+    I2S1.int_ena.out_eof = 1;
+
+    // Laufenden Ring auf den neuen Puffer umleiten: der DMA beendet den
+    // aktuellen Durchlauf und bleibt danach im neuen Ring
+    descriptors[front][descriptorCount[front] - 1].qe.stqe_next = &descriptors[back][0];
+    front = back;
+#else
+    (void)frames;
+    (void)frameCount;
+    (void)channelCount;
+#endif
+}
+
+void IRAM_ATTR I2SRefreshDriver::eofIsr(void* arg) {
+#if CONFIG_IDF_TARGET_ESP32
+    I2SRefreshDriver* self = static_cast<I2SRefreshDriver*>(arg);
+    I2S1.int_clr.out_eof = 1;
+
+    // Sobald der letzte Deskriptor des neuen Puffers sein EOF gemeldet hat,
+    // liest der DMA den alten Puffer nicht mehr
+    if (self->swapPending && I2S1.out_eof_des_addr == self->swapDesc) {
+        I2S1.int_ena.out_eof = 0;
+        self->swapPending = false;
+        self->transferComplete();
+
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR(self->swapSignal, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+#else
+    (void)arg;
+#endif
+}
+
+bool I2SRefreshDriver::waitForSwap() {
+    if (!swapPending) {
+        return true;
+    }
+
+    // Nur bei direktem loadFrames() während eines Wechsels: blockiert
+    // auf das Signal der EOF-ISR, höchstens zwei Durchläufe (auf Ticks
+    // aufgerundet). Ein altes Signal ohne Wartenden weckt nur zu früh.
+    TickType_t timeout = pdMS_TO_TICKS((swapTimeoutUs + 999) / 1000) + 1;
+    TickType_t start = xTaskGetTickCount();
+    while (swapPending) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout || xSemaphoreTake(swapSignal, timeout - elapsed) != pdTRUE) {
+            if (!swapPending) {
+                break;
+            }
+            // Alter Puffer evtl. noch in Benutzung: nicht überschreiben
+            Serial.println("[I2SRefresh] ERROR: DMA buffer swap timeout, frame skipped!");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool I2SRefreshDriver::loadFrames(const uint32_t* frames, uint16_t frameCount, uint16_t channelCount) {
+#if CONFIG_IDF_TARGET_ESP32
+    if (!configured || frameCount < 1 || frameCount > maxFrames ||
+        channelCount < 1 || channelCount > LATCH_MAX_CHANNELS) {
+        return false;
+    }
+
+    // Erster Frame: Ring aufbauen und DMA starten
+    if (!running) {
+        uint16_t samples = frameSamples(channelCount);
+        uint8_t words = LATCH_WORD_COUNT(channelCount);
+        for (uint16_t f = 0; f < frameCount; f++) {
+            renderFrame(buffers[front] + (uint32_t)f * samples, frames + (uint32_t)f * words, channelCount);
+        }
+        linkDescriptors(front, (uint32_t)frameCount * samples * 2);
+        start();
+        return true;
+    }
+
+    // Hinteren Puffer erst beschreiben, wenn der DMA ihn verlassen hat
+    if (!waitForSwap()) {
+        return false;
+    }
+    swapIn(frames, frameCount, channelCount);
+    return true;
+#else
+    (void)frames;
+    (void)frameCount;
+    (void)channelCount;
+    return false;
+#endif
+}
+
+bool I2SRefreshDriver::supportsAsync() {
+    return configured;
+}
+
+bool I2SRefreshDriver::submit(const uint32_t* data, uint16_t channelCount) {
+    // Erster Frame startet den DMA und ist sofort sichtbar
+    if (!running) {
+        if (!loadFrames(data, 1, channelCount)) {
+            return false;
+        }
+        transferComplete();
+        return true;
+    }
+
+    // LatchController reicht erst nach transferComplete() nach: der
+    // Wechsel ist hier abgeschlossen, sonst scheitert der Transfer und
+    // der Controller unterdrückt die nächste Ausgabe nicht
+    if (swapPending || channelCount < 1 || channelCount > LATCH_MAX_CHANNELS) {
+        return false;
+    }
+    swapIn(data, 1, channelCount);
+    return true;
+}
+
+void I2SRefreshDriver::updateHardware(uint32_t data, uint8_t channelCount) {
+    loadFrames(&data, 1, channelCount);
+}
+
+void I2SRefreshDriver::updateHardwareWords(const uint32_t* data, uint16_t channelCount) {
+    loadFrames(data, 1, channelCount);
+}
+
+uint32_t I2SRefreshDriver::getRefreshRate(uint16_t channelCount) const {
+    return clockHz / frameSamples(channelCount);
+}
+
+const char* I2SRefreshDriver::getName() {
+    return "74HC595 I2S Refresh";
+}
+
+uint8_t I2SRefreshDriver::getMaxChannels() {
+    uint16_t capacity = getChannelCapacity();
+    return (capacity > 255) ? 255 : (uint8_t)capacity;
+}
+
+uint16_t I2SRefreshDriver::getChannelCapacity() {
+    return LATCH_MAX_CHANNELS;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file I2SRefreshDriver.h
+ * @brief Dauer-Refresh für 74HC595-Ketten über I2S-Parallelmodus mit DMA
+ *
+ * Der I2S1-Peripheriebaustein läuft im LCD-Modus (16 Bit parallel) und
+ * liest einen Ring aus DMA-Deskriptoren endlos aus. Jedes 16-Bit-Sample
+ * ist eine Taktflanke:
+ * - Bit 0..chains-1: DS der Ketten (bit-sliced wie ShiftRegisterDriver)
+ * - Bit chains:      STCP (Latch), HIGH im Sample nach dem letzten Datenbit
+ * - WS-Takt:         SHCP aller Ketten
+ *
+ * Die Kette wird so ohne CPU-Last mit mehreren kHz neu geschrieben
+ * (LED-Matrizen, Multiplexing). submit() rendert nur den neuen Frame in
+ * den hinteren Puffer und hängt ihn per Deskriptor-Link an; der DMA
+ * wechselt am Ende des laufenden Durchlaufs. Der EOF-Interrupt des neuen
+ * Rings meldet den Wechsel als abgeschlossenen Transfer, bis dahin
+ * sammelt LatchController neuere Zustände (asynchroner Vertrag).
+ *
+ * loadFrames() lädt eine Folge mehrerer Frames (z.B. Multiplex-Zeilen),
+ * die nacheinander und danach wieder von vorn ausgegeben werden.
+ *
+ * init() richtet nur Puffer und Peripherie ein; der DMA startet mit dem
+ * ersten Frame (bei LatchController::begin() der Startzustand), damit
+ * ACTIVE_LOW-Lasten nie kurz mit einem Nullframe angesteuert werden.
+ *
+ * Nur ESP32 (klassisch): I2S-LCD-Modus und lldesc-Ring sind
+ * chipspezifisch. Auf anderen Chips schlägt init() fehl.
+ */
+
+#ifndef I2S_REFRESH_DRIVER_H
+#define I2S_REFRESH_DRIVER_H
+
+#include "LatchController.h"
+#include "esp_intr_alloc.h"
+
+/// Maximale Anzahl Ketten (16 Bit Bus, ein Bit für STCP)
+#define I2S_REFRESH_MAX_CHAINS 15
+
+struct lldesc_s;
+
+/**
+ * @class I2SRefreshDriver
+ * @brief 74HC595-Driver mit kontinuierlicher DMA-Ausgabe
+ */
+class I2SRefreshDriver : public LatchDriver {
+private:
+    uint8_t chainPins[I2S_REFRESH_MAX_CHAINS];
+    uint8_t chainCount;
+    uint8_t clockPin;     // SHCP aller Ketten (I2S WS)
+    uint8_t latchPin;     // STCP aller Ketten
+    uint32_t clockHz;
+    uint16_t maxFrames;
+
+    // Doppelpuffer: front wird vom DMA gelesen, der andere beschrieben
+    uint16_t* buffers[2];
+    struct lldesc_s* descriptors[2];
+    uint16_t descriptorCount[2];
+    uint16_t maxDescriptors;
+    uint32_t bufferSize;      // Bytes pro Puffer
+    uint8_t front;
+    volatile bool swapPending; // DMA hat den neuen Puffer noch nicht erreicht
+    uint32_t swapDesc;        // Letzter Deskriptor des neuen Rings (EOF-Adresse)
+    uint32_t swapTimeoutUs;   // Zwei Durchläufe eines vollen Puffers
+    StaticSemaphore_t swapSignalBuffer;
+    SemaphoreHandle_t swapSignal;   // EOF-ISR → waitForSwap()
+    intr_handle_t eofInterrupt;
+    bool configured;          // Peripherie eingerichtet, Puffer vorhanden
+    bool running;             // DMA läuft (ab dem ersten Frame)
+
+    uint16_t frameSamples(uint16_t channelCount) const;
+    void renderFrame(uint16_t* samples, const uint32_t* data, uint16_t channelCount);
+    void linkDescriptors(uint8_t index, uint32_t bytes);
+    void swapIn(const uint32_t* frames, uint16_t frameCount, uint16_t channelCount);
+    bool waitForSwap();
+    static void eofIsr(void* arg);
+    bool initPeripheral();
+    void start();
+    void stop();
+
+public:
+    /**
+     * @brief Konstruktor für eine Kette
+     * @param data DS Pin
+     * @param clock SHCP Pin
+     * @param latch STCP Pin
+     * @param clockHz Schiebetakt in Hz
+     * @param maxFrames Maximale Frames pro loadFrames()-Folge
+     */
+    I2SRefreshDriver(uint8_t data, uint8_t clock, uint8_t latch,
+                     uint32_t clockHz = 10000000, uint16_t maxFrames = 1);
+
+    /**
+     * @brief Konstruktor für parallele Ketten
+     *
+     * Aufteilung wie bei ShiftRegisterDriver: Kette c übernimmt die
+     * Kanäle c*L bis c*L+L-1 mit L = channelCount / chains (aufgerundet).
+     *
+     * @param dataPins Array mit DS-Pins (ein Pin pro Kette)
+     * @param chains Anzahl Ketten (1 bis I2S_REFRESH_MAX_CHAINS)
+     * @param clock Gemeinsamer SHCP Pin
+     * @param latch Gemeinsamer STCP Pin
+     * @param clockHz Schiebetakt in Hz
+     * @param maxFrames Maximale Frames pro loadFrames()-Folge
+     */
+    I2SRefreshDriver(const uint8_t* dataPins, uint8_t chains, uint8_t clock, uint8_t latch,
+                     uint32_t clockHz = 10000000, uint16_t maxFrames = 1);
+    ~I2SRefreshDriver();
+
+    bool init() override;
+    void updateHardware(uint32_t data, uint8_t channelCount) override;
+    void updateHardwareWords(const uint32_t* data, uint16_t channelCount) override;
+    const char* getName() override;
+    uint8_t getMaxChannels() override;
+    uint16_t getChannelCapacity() override;
+    bool supportsAsync() override;
+    bool submit(const uint32_t* data, uint16_t channelCount) override;
+
+    /**
+     * @brief Folge von Frames zur Endlosausgabe laden
+     *
+     * Frame f beginnt bei frames[f * LATCH_WORD_COUNT(channelCount)].
+     * Blockiert (ohne aktives Warten), bis der DMA den zuletzt geladenen
+     * Puffer erreicht hat: höchstens zwei Durchläufe eines vollen
+     * Puffers, auf FreeRTOS-Ticks aufgerundet.
+     * Erreicht er ihn nicht rechtzeitig, wird die Folge verworfen, statt
+     * den gelesenen Puffer zu überschreiben.
+     *
+     * @param frames Ausgabedaten aller Frames (bereits invertiert, falls ACTIVE_LOW)
+     * @param frameCount Anzahl Frames (1 bis maxFrames)
+     * @param channelCount Kanäle pro Frame
+     * @return false bei ungültigen Parametern, nicht initialisiert oder
+     *         Timeout beim Pufferwechsel
+     */
+    bool loadFrames(const uint32_t* frames, uint16_t frameCount, uint16_t channelCount);
+
+    /**
+     * @brief Refresh-Rate eines Frames
+     * @param channelCount Kanäle pro Frame
+     * @return Frames pro Sekunde (ungefähr, abhängig vom Taktteiler)
+     */
+    uint32_t getRefreshRate(uint16_t channelCount) const;
+};
+
+#endif // I2S_REFRESH_DRIVER_H
@@ -4,75 +4,371 @@
  */
 
 #include "ShiftRegisterDriver.h"
+#include "esp_heap_caps.h"
+
+// Größe des DMA-Puffers: ganze Kette, auf 32 Bit aufgerundet
+#define SR_SPI_BUFFER_SIZE (LATCH_STATE_WORDS * 4)
 
 // Konstruktor für 74HC595 (mit Latch)
-ShiftRegisterDriver::ShiftRegisterDriver(uint8_t data, uint8_t clock, uint8_t latch, uint8_t oe) {
+ShiftRegisterDriver::ShiftRegisterDriver(uint8_t data, uint8_t clock, uint8_t latch, uint8_t oe)
+    : ShiftRegisterDriver(data, clock, latch, oe, SR_BUS_BITBANG) {
+}
+
+// Konstruktor für 74HC595 mit wählbarer Übertragung
+ShiftRegisterDriver::ShiftRegisterDriver(uint8_t data, uint8_t clock, uint8_t latch, uint8_t oe,
+                                         ShiftRegisterBus busType, uint32_t clockHz) {
     dataPin = data;
     clockPin = clock;
     latchPin = latch;
     oePin = oe;
     type = SR_74HC595;
+    bus = busType;
+    spiClockHz = clockHz;
+    spiDevice = nullptr;
+    spiBuffer = nullptr;
+    spiTrans = {};
+    spiQueued = false;
+    spiAsync = false;
+    oeLedcChannel = 0xFF;
+    oePwmHz = 0;
+    oeBrightness = 255;
+    chainCount = 1;
+    chainPins[0] = data;
+    for (uint8_t c = 0; c < SR_MAX_CHAINS; c++) {
+        chainOut[c].attach(0xFF);
+    }
+    clockOut.attach(0xFF);
+    latchOut.attach(0xFF);
 }
 
 // Konstruktor für 74HC164 (ohne Latch)
-ShiftRegisterDriver::ShiftRegisterDriver(uint8_t data, uint8_t clock) {
-    dataPin = data;
-    clockPin = clock;
-    latchPin = 0xFF;
-    oePin = 0xFF;
+ShiftRegisterDriver::ShiftRegisterDriver(uint8_t data, uint8_t clock)
+    : ShiftRegisterDriver(data, clock, 0xFF, 0xFF, SR_BUS_BITBANG) {
     type = SR_74HC164;
 }
 
+// Konstruktor für parallele Ketten
+ShiftRegisterDriver::ShiftRegisterDriver(const uint8_t* dataPins, uint8_t chains, uint8_t clock,
+                                         uint8_t latch, uint8_t oe)
+    : ShiftRegisterDriver(dataPins[0], clock, latch, oe, SR_BUS_BITBANG) {
+    chainCount = (chains < 1) ? 1 : ((chains > SR_MAX_CHAINS) ? SR_MAX_CHAINS : chains);
+    for (uint8_t c = 0; c < chainCount; c++) {
+        chainPins[c] = dataPins[c];
+    }
+}
+
+ShiftRegisterDriver::~ShiftRegisterDriver() {
+    if (spiDevice != nullptr) {
+        spi_bus_remove_device(spiDevice);
+        spi_bus_free(bus == SR_BUS_HSPI ? SPI2_HOST : SPI3_HOST);
+    }
+    if (spiBuffer != nullptr) {
+        heap_caps_free(spiBuffer);
+    }
+}
+
 bool ShiftRegisterDriver::init() {
-    // Configure pins
-    pinMode(dataPin, OUTPUT);
-    pinMode(clockPin, OUTPUT);
+    // Configure pins (im SPI-Modus übernimmt der SPI-Treiber DATA/CLOCK)
+    if (bus != SR_BUS_BITBANG) {
+        if (!initSpi()) {
+            return false;
+        }
+    } else {
+        for (uint8_t c = 0; c < chainCount; c++) {
+            pinMode(chainPins[c], OUTPUT);
+            digitalWrite(chainPins[c], LOW);
+            chainOut[c].attach(chainPins[c]);
+        }
+        pinMode(clockPin, OUTPUT);
+        digitalWrite(clockPin, LOW);
+        clockOut.attach(clockPin);
+    }
     
     if (latchPin != 0xFF) {
         pinMode(latchPin, OUTPUT);
         digitalWrite(latchPin, LOW);
+        latchOut.attach(latchPin);
     }
     
-    if (oePin != 0xFF) {
+    if (oePin != 0xFF && oeLedcChannel != 0xFF) {
+        if (!initOePwm()) {
+            return false;
+        }
+    } else if (oePin != 0xFF) {
         pinMode(oePin, OUTPUT);
         digitalWrite(oePin, LOW);  // Output Enable active
     }
     
-    digitalWrite(dataPin, LOW);
-    digitalWrite(clockPin, LOW);
-    
     Serial.printf("[ShiftRegister] Initialized: %s\n", getName());
-    Serial.printf("  DATA=%d, CLOCK=%d", dataPin, clockPin);
+    Serial.printf("  DATA=%d", dataPin);
+    for (uint8_t c = 1; c < chainCount; c++) {
+        Serial.printf("/%d", chainPins[c]);
+    }
+    Serial.printf(", CLOCK=%d", clockPin);
     if (latchPin != 0xFF) Serial.printf(", LATCH=%d", latchPin);
     if (oePin != 0xFF) Serial.printf(", OE=%d", oePin);
+    if (oeLedcChannel != 0xFF) Serial.printf(" (LEDC %d @ %u Hz)", oeLedcChannel, oePwmHz);
+    if (bus != SR_BUS_BITBANG) {
+        Serial.printf(", %s @ %u kHz (DMA)", bus == SR_BUS_HSPI ? "HSPI" : "VSPI", spiClockHz / 1000);
+    }
     Serial.println();
     
     return true;
 }
 
-void ShiftRegisterDriver::shiftOut(uint32_t data, uint8_t bits) {
-    // MSB-First Übertragung
-    for (int8_t i = bits - 1; i >= 0; i--) {
-        digitalWrite(clockPin, LOW);
-        digitalWrite(dataPin, (data & (1UL << i)) ? HIGH : LOW);
-        digitalWrite(clockPin, HIGH);
+bool ShiftRegisterDriver::initSpi() {
+    if (spiDevice != nullptr) {
+        return true;
+    }
+
+    // HSPI = SPI2, VSPI = SPI3 (Chips ohne SPI3 fallen auf SPI2 zurück)
+#if SOC_SPI_PERIPH_NUM > 2
+    spi_host_device_t host = (bus == SR_BUS_HSPI) ? SPI2_HOST : SPI3_HOST;
+#else
+    spi_host_device_t host = SPI2_HOST;
+    bus = SR_BUS_HSPI;
+#endif
+
+    // Puffer eines fehlgeschlagenen Versuchs wiederverwenden
+    if (spiBuffer == nullptr) {
+        spiBuffer = (uint8_t*)heap_caps_malloc(SR_SPI_BUFFER_SIZE, MALLOC_CAP_DMA);
+    }
+    if (spiBuffer == nullptr) {
+        Serial.println("[ShiftRegister] ERROR: DMA buffer allocation failed!");
+        return false;
+    }
+
+    spi_bus_config_t busConfig = {};
+    busConfig.mosi_io_num = dataPin;
+    busConfig.miso_io_num = -1;
+    busConfig.sclk_io_num = clockPin;
+    busConfig.quadwp_io_num = -1;
+    busConfig.quadhd_io_num = -1;
+    busConfig.max_transfer_sz = SR_SPI_BUFFER_SIZE;
+
+    esp_err_t err = spi_bus_initialize(host, &busConfig, SPI_DMA_CH_AUTO);
+    if (err != ESP_OK) {
+        Serial.printf("[ShiftRegister] ERROR: SPI bus init failed (%s)\n", esp_err_to_name(err));
+        return false;
+    }
+
+    // Mode 0: Daten gültig bei steigender SHCP-Flanke, kein CS (STCP manuell)
+    spi_device_interface_config_t devConfig = {};
+    devConfig.mode = 0;
+    devConfig.clock_speed_hz = spiClockHz;
+    devConfig.spics_io_num = -1;
+    devConfig.queue_size = 1;
+    devConfig.post_cb = spiPostCallback;
+
+    err = spi_bus_add_device(host, &devConfig, &spiDevice);
+    if (err != ESP_OK) {
+        Serial.printf("[ShiftRegister] ERROR: SPI device add failed (%s)\n", esp_err_to_name(err));
+        spi_bus_free(host);
+        spiDevice = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void IRAM_ATTR ShiftRegisterDriver::spiPostCallback(spi_transaction_t* trans) {
+    // DMA-Transfer abgeschlossen → STCP HIGH übernimmt die Daten
+    ShiftRegisterDriver* self = static_cast<ShiftRegisterDriver*>(trans->user);
+    self->latchOut.high();
+
+    if (self->spiAsync) {
+        self->spiAsync = false;
+        self->transferComplete();
+    }
+}
+
+void ShiftRegisterDriver::packChain(const uint32_t* data, uint16_t bits, uint8_t* out) {
+    // Byte k enthält die Kanäle (bits-1-8k) ... (bits-8-8k), MSB zuerst
+    uint16_t byteCount = (bits + 7) / 8;
+    for (uint16_t k = 0; k < byteCount; k++) {
+        int32_t low = (int32_t)bits - 8 * (k + 1);
+        int32_t start = (low < 0) ? 0 : low;
+        uint32_t word = data[start >> 5] >> (start & 31);
+        if ((start & 31) > 24) {
+            word |= data[(start >> 5) + 1] << (32 - (start & 31));
+        }
+        // Letztes Byte bei bits % 8 != 0: linksbündig auffüllen
+        out[k] = (low < 0) ? (uint8_t)(word << (-low)) : (uint8_t)word;
+    }
+}
+
+void ShiftRegisterDriver::writeChainSpi(const uint32_t* data, uint16_t bits) {
+    // Offenes Ergebnis eines asynchronen Transfers zuerst abholen
+    if (spiQueued) {
+        spi_transaction_t* done;
+        spi_device_get_trans_result(spiDevice, &done, portMAX_DELAY);
+        spiQueued = false;
+    }
+
+    latchOut.low();
+
+    packChain(data, bits, spiBuffer);
+
+    // Blockiert nur den aufrufenden Task, die CPU ist während DMA frei
+    spi_transaction_t trans = {};
+    trans.length = bits;
+    trans.tx_buffer = spiBuffer;
+    trans.user = this;
+    spi_device_transmit(spiDevice, &trans);
+}
+
+bool ShiftRegisterDriver::supportsAsync() {
+    return spiDevice != nullptr;
+}
+
+bool ShiftRegisterDriver::submit(const uint32_t* data, uint16_t channelCount) {
+    if (spiDevice == nullptr) {
+        return LatchDriver::submit(data, channelCount);
+    }
+
+    // Ergebnis des vorherigen Transfers abholen (bereits abgeschlossen)
+    if (spiQueued) {
+        spi_transaction_t* done;
+        spi_device_get_trans_result(spiDevice, &done, portMAX_DELAY);
+        spiQueued = false;
+    }
+
+    latchOut.low();
+    packChain(data, channelCount, spiBuffer);
+
+    spiTrans = {};
+    spiTrans.length = channelCount;
+    spiTrans.tx_buffer = spiBuffer;
+    spiTrans.user = this;
+
+    spiAsync = true;
+    if (spi_device_queue_trans(spiDevice, &spiTrans, 0) != ESP_OK) {
+        spiAsync = false;
+        return false;
+    }
+    spiQueued = true;
+    return true;
+}
+
+bool ShiftRegisterDriver::setOePwm(uint8_t ledcChannel, uint32_t frequencyHz) {
+    if (oePin == 0xFF || ledcChannel >= LEDC_CHANNEL_MAX) {
+        Serial.println("[ShiftRegister] ERROR: OE PWM needs an OE pin and a valid LEDC channel");
+        return false;
     }
-    digitalWrite(clockPin, LOW);
+    oeLedcChannel = ledcChannel;
+    oePwmHz = frequencyHz;
+    return true;
+}
+
+bool ShiftRegisterDriver::initOePwm() {
+    ledc_timer_config_t timerConfig = {};
+    timerConfig.speed_mode = LEDC_LOW_SPEED_MODE;
+    timerConfig.duty_resolution = LEDC_TIMER_8_BIT;
+    timerConfig.timer_num = (ledc_timer_t)((oeLedcChannel / 2) % LEDC_TIMER_MAX);
+    timerConfig.freq_hz = oePwmHz;
+    timerConfig.clk_cfg = LEDC_AUTO_CLK;
+
+    esp_err_t err = ledc_timer_config(&timerConfig);
+    if (err != ESP_OK) {
+        Serial.printf("[ShiftRegister] ERROR: LEDC timer config failed (%s)\n", esp_err_to_name(err));
+        return false;
+    }
+
+    // Invertiert: Tastverhältnis = Anteil mit OE LOW (Ausgänge aktiv)
+    ledc_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = oePin;
+    channelConfig.speed_mode = LEDC_LOW_SPEED_MODE;
+    channelConfig.channel = (ledc_channel_t)oeLedcChannel;
+    channelConfig.intr_type = LEDC_INTR_DISABLE;
+    channelConfig.timer_sel = timerConfig.timer_num;
+    channelConfig.duty = oeDuty(oeBrightness);
+    channelConfig.hpoint = 0;
+    channelConfig.flags.output_invert = 1;
+
+    err = ledc_channel_config(&channelConfig);
+    if (err != ESP_OK) {
+        Serial.printf("[ShiftRegister] ERROR: LEDC channel config failed (%s)\n", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+uint32_t ShiftRegisterDriver::oeDuty(uint8_t level) {
+    // 8 Bit: 256 = dauerhaft aktiv, 255 wäre 1/256 dunkel
+    return (level == 255) ? 256 : level;
+}
+
+bool ShiftRegisterDriver::supportsBrightness() {
+    return oeLedcChannel != 0xFF;
+}
+
+void ShiftRegisterDriver::setBrightness(uint8_t level) {
+    oeBrightness = level;
+    if (oeLedcChannel == 0xFF) {
+        return;
+    }
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)oeLedcChannel, oeDuty(level));
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)oeLedcChannel);
+}
+
+void ShiftRegisterDriver::shiftOut(const uint32_t* data, uint16_t bits) {
+    // MSB-First Übertragung, Wort für Wort (höchster Kanal zuerst)
+    // Direkte Registerzugriffe statt digitalWrite()
+    for (int16_t i = bits - 1; i >= 0; i--) {
+        uint32_t word = data[i >> 5];
+        clockOut.low();
+        chainOut[0].write((word & (1UL << (i & 31))) != 0);
+        clockOut.high();
+    }
+    clockOut.low();
+}
+
+void ShiftRegisterDriver::shiftOutParallel(const uint32_t* data, uint16_t bits) {
+    // Kette c hält die Kanäle c*length ... c*length+length-1
+    uint16_t length = (bits + chainCount - 1) / chainCount;
+
+    // Pro Taktflanke: CLOCK LOW + alle DATA-Pins in einem Schreibzugriff
+    for (int16_t i = length - 1; i >= 0; i--) {
+        FastPinSet edge;
+        edge.reset();
+        edge.add(clockOut, false);
+        for (uint8_t c = 0; c < chainCount; c++) {
+            uint16_t channel = c * length + i;
+            bool level = (channel < bits) && (data[channel >> 5] & (1UL << (channel & 31)));
+            edge.add(chainOut[c], level);
+        }
+        edge.apply();
+        clockOut.high();
+    }
+    clockOut.low();
 }
 
 void ShiftRegisterDriver::updateHardware(uint32_t data, uint8_t channelCount) {
-    // Latch LOW (wenn vorhanden)
-    if (latchPin != 0xFF) {
-        digitalWrite(latchPin, LOW);
+    writeChain(&data, channelCount);
+}
+
+void ShiftRegisterDriver::updateHardwareWords(const uint32_t* data, uint16_t channelCount) {
+    writeChain(data, channelCount);
+}
+
+void ShiftRegisterDriver::writeChain(const uint32_t* data, uint16_t channelCount) {
+    if (spiDevice != nullptr) {
+        writeChainSpi(data, channelCount);
+        return;
     }
+
+    // Latch LOW (ohne Latch-Pin wirkungslos)
+    latchOut.low();
     
     // Daten schieben
-    shiftOut(data, channelCount);
+    if (chainCount > 1) {
+        shiftOutParallel(data, channelCount);
+    } else {
+        shiftOut(data, channelCount);
+    }
     
     // Latch HIGH → Daten übernehmen
-    if (latchPin != 0xFF) {
-        digitalWrite(latchPin, HIGH);
-    }
+    latchOut.high();
 }
 
 const char* ShiftRegisterDriver::getName() {
@@ -85,5 +381,10 @@ const char* ShiftRegisterDriver::getName() {
 }
 
 uint8_t ShiftRegisterDriver::getMaxChannels() {
-    return 32;  // Theoretisch unbegrenzt kaskadierbar, praktisch 32 Bit
+    uint16_t capacity = getChannelCapacity();
+    return (capacity > 255) ? 255 : (uint8_t)capacity;
+}
+
+uint16_t ShiftRegisterDriver::getChannelCapacity() {
+    return LATCH_MAX_CHANNELS;  // Kaskadierbar, begrenzt durch LatchState
 }
@@ -6,13 +6,32 @@
  * - 74HC595 (8-Bit mit Storage Register)
  * - 74HC164 (8-Bit ohne Storage Register)
  * - 74HC4094 (8-Bit mit Strobe)
- * - Kaskadierbar für 16, 24, 32+ Bit
+ * - Kaskadierbar für 16, 24, 32+ Bit (bis LATCH_MAX_CHANNELS mit einem Latch-Puls)
+ * - Mehrere parallele Ketten (eigene DATA-Pins, gemeinsamer CLOCK/LATCH),
+ *   bit-sliced: jede Taktflanke schiebt ein Bit in alle Ketten gleichzeitig
+ * 
+ * Übertragung:
+ * - Bit-Bang über GPIO (beliebige Pins)
+ * - Hardware-SPI (HSPI/VSPI) mit DMA für lange Ketten und hohe Taktraten
+ *   (asynchron: LatchController wartet nicht auf das Ende des Transfers)
+ * 
+ * Dimmung:
+ * - OE optional an einem LEDC-PWM-Kanal (setOePwm()), globale Helligkeit
+ *   ohne CPU-Last und ohne zusätzliches Schieben
  */
 
 #ifndef SHIFT_REGISTER_DRIVER_H
 #define SHIFT_REGISTER_DRIVER_H
 
 #include "LatchController.h"
+#include "FastGpio.h"
+#include "driver/spi_master.h"
+#include "driver/ledc.h"
+
+/// Maximale Anzahl paralleler Ketten (DATA-Pins)
+#ifndef SR_MAX_CHAINS
+#define SR_MAX_CHAINS 8
+#endif
 
 /**
  * @enum ShiftRegisterType
@@ -24,19 +43,60 @@ enum ShiftRegisterType {
     SR_74HC4094   // Mit STROBE
 };
 
+/**
+ * @enum ShiftRegisterBus
+ * @brief Übertragungsart für DATA/CLOCK
+ */
+enum ShiftRegisterBus {
+    SR_BUS_BITBANG,   // Software über GPIO (Standard)
+    SR_BUS_HSPI,      // SPI2-Peripherie mit DMA
+    SR_BUS_VSPI       // SPI3-Peripherie mit DMA
+};
+
 /**
  * @class ShiftRegisterDriver
  * @brief Driver für Shift-Register basierte Latches
  */
 class ShiftRegisterDriver : public LatchDriver {
 private:
-    uint8_t dataPin;      // DS / Serial Data
+    uint8_t dataPin;      // DS / Serial Data (Kette 0)
     uint8_t clockPin;     // SHCP / Clock
     uint8_t latchPin;     // STCP / Latch (nur 74HC595)
     uint8_t oePin;        // Output Enable (optional)
     ShiftRegisterType type;
 
-    void shiftOut(uint32_t data, uint8_t bits);
+    // Parallele Ketten (chainPins[0] == dataPin)
+    uint8_t chainCount;
+    uint8_t chainPins[SR_MAX_CHAINS];
+
+    // Vorberechnete Register (in init() gesetzt)
+    FastPin chainOut[SR_MAX_CHAINS];
+    FastPin clockOut;
+    FastPin latchOut;
+
+    // SPI-Modus
+    ShiftRegisterBus bus;
+    uint32_t spiClockHz;
+    spi_device_handle_t spiDevice;
+    uint8_t* spiBuffer;           // DMA-fähiger Sendepuffer
+    spi_transaction_t spiTrans;   // Laufende asynchrone Transaktion
+    bool spiQueued;               // Ergebnis noch abzuholen
+    volatile bool spiAsync;       // Post-Callback meldet Abschluss
+
+    // OE-Dimmung über LEDC
+    uint8_t oeLedcChannel;        // 0xFF = OE als normaler GPIO
+    uint32_t oePwmHz;
+    uint8_t oeBrightness;
+
+    void shiftOut(const uint32_t* data, uint16_t bits);
+    void shiftOutParallel(const uint32_t* data, uint16_t bits);
+    void writeChain(const uint32_t* data, uint16_t bits);
+    bool initSpi();
+    void writeChainSpi(const uint32_t* data, uint16_t bits);
+    static void packChain(const uint32_t* data, uint16_t bits, uint8_t* out);
+    static void spiPostCallback(spi_transaction_t* trans);
+    bool initOePwm();
+    static uint32_t oeDuty(uint8_t level);
 
 public:
     /**
@@ -48,6 +108,18 @@ public:
      */
     ShiftRegisterDriver(uint8_t data, uint8_t clock, uint8_t latch, uint8_t oe = 0xFF);
 
+    /**
+     * @brief Konstruktor für 74HC595 mit wählbarer Übertragung
+     * @param data DS Pin (MOSI im SPI-Modus)
+     * @param clock SHCP Pin (SCLK im SPI-Modus)
+     * @param latch STCP Pin (wird nach Abschluss des DMA-Transfers gepulst)
+     * @param oe OE Pin (0xFF wenn nicht verwendet)
+     * @param bus SR_BUS_BITBANG, SR_BUS_HSPI oder SR_BUS_VSPI
+     * @param clockHz SPI-Takt in Hz (nur SPI-Modus)
+     */
+    ShiftRegisterDriver(uint8_t data, uint8_t clock, uint8_t latch, uint8_t oe,
+                        ShiftRegisterBus bus, uint32_t clockHz = 8000000);
+
     /**
      * @brief Konstruktor für 74HC164 (ohne Latch)
      * @param data DS Pin
@@ -55,10 +127,46 @@ public:
      */
     ShiftRegisterDriver(uint8_t data, uint8_t clock);
 
+    /**
+     * @brief Konstruktor für mehrere parallele 74HC595-Ketten
+     * 
+     * Die Kanäle werden gleichmäßig aufgeteilt: Kette c übernimmt die
+     * Kanäle c*L bis c*L+L-1 mit L = channelCount / chains (aufgerundet).
+     * Die Schiebezeit sinkt um den Faktor der Kettenanzahl.
+     * 
+     * @param dataPins Array mit DS-Pins (ein Pin pro Kette)
+     * @param chains Anzahl Ketten (1 bis SR_MAX_CHAINS)
+     * @param clock Gemeinsamer SHCP Pin
+     * @param latch Gemeinsamer STCP Pin
+     * @param oe Gemeinsamer OE Pin (0xFF wenn nicht verwendet)
+     */
+    ShiftRegisterDriver(const uint8_t* dataPins, uint8_t chains, uint8_t clock, uint8_t latch,
+                        uint8_t oe = 0xFF);
+    ~ShiftRegisterDriver();
+
     bool init() override;
     void updateHardware(uint32_t data, uint8_t channelCount) override;
+    void updateHardwareWords(const uint32_t* data, uint16_t channelCount) override;
     const char* getName() override;
     uint8_t getMaxChannels() override;
+    uint16_t getChannelCapacity() override;
+    bool supportsAsync() override;
+    bool submit(const uint32_t* data, uint16_t channelCount) override;
+    bool supportsBrightness() override;
+    void setBrightness(uint8_t level) override;
+
+    /**
+     * @brief OE über einen LEDC-PWM-Kanal ansteuern (vor init() aufrufen)
+     * 
+     * Der Kanal wird invertiert ausgegeben (OE ist LOW-aktiv), das
+     * Tastverhältnis entspricht damit direkt der Helligkeit. Der
+     * LEDC-Timer ergibt sich wie beim Arduino-Core aus channel / 2.
+     * 
+     * @param ledcChannel LEDC-Kanal (0 bis LEDC_CHANNEL_MAX-1)
+     * @param frequencyHz PWM-Frequenz (Standard 20 kHz, unhörbar)
+     * @return false ohne OE-Pin oder bei ungültigem Kanal
+     */
+    bool setOePwm(uint8_t ledcChannel, uint32_t frequencyHz = 20000);
 };
 
 #endif // SHIFT_REGISTER_DRIVER_H
@@ -0,0 +1,89 @@
+/**
+ * @file test_change_notification.cpp
+ * @brief Observer and snapshot baseline after begin() (runs on the ESP32)
+ *
+ * pio test -e esp32dev
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include "LatchController.h"
+
+// Records the last output instead of driving pins
+class RecordingDriver : public LatchDriver {
+public:
+    uint32_t output = 0;
+
+    bool init() override { return true; }
+    void updateHardware(uint32_t data, uint8_t /*channelCount*/) override { output = data; }
+    const char* getName() override { return "Recording"; }
+    uint8_t getMaxChannels() override { return 32; }
+};
+
+static LatchChange lastChange;
+static uint32_t notifications;
+
+static void recordChange(const LatchChange& change, void* /*context*/) {
+    lastChange = change;
+    notifications++;
+}
+
+void setUp() {
+    notifications = 0;
+}
+
+void tearDown() {
+}
+
+void test_power_on_state_is_baseline() {
+    RecordingDriver driver;
+    LatchController controller(&driver, 8);
+    uint32_t powerOn = 0x0F;
+    controller.setPowerOnState(&powerOn, 1);
+    controller.subscribe(recordChange);
+
+    TEST_ASSERT_TRUE(controller.begin());
+    TEST_ASSERT_EQUAL_HEX32(0x0F, driver.output);
+
+    // Restoring is not a change
+    LatchSnapshot snap;
+    controller.getSnapshot(snap);
+    TEST_ASSERT_EQUAL_HEX32(0x0F, snap.mask.words[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.sequence);
+
+    // First notification only reports the channel switched afterwards
+    controller.setLatchOn(7);
+    TEST_ASSERT_EQUAL_UINT32(1, notifications);
+    TEST_ASSERT_EQUAL_HEX32(0x0F, lastChange.oldMask.words[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x8F, lastChange.newMask.words[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x80, lastChange.changedMask.words[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, lastChange.sequence);
+}
+
+void test_batch_is_one_notification() {
+    RecordingDriver driver;
+    LatchController controller(&driver, 8);
+    controller.subscribe(recordChange);
+    TEST_ASSERT_TRUE(controller.begin());
+
+    {
+        LatchTransaction tx(controller);
+        controller.setLatchOn(1);
+        controller.setLatchOn(2);
+        TEST_ASSERT_EQUAL_UINT32(0, notifications);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1, notifications);
+    TEST_ASSERT_EQUAL_HEX32(0x06, lastChange.changedMask.words[0]);
+}
+
+void setup() {
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_power_on_state_is_baseline);
+    RUN_TEST(test_batch_is_one_notification);
+    UNITY_END();
+}
+
+void loop() {
+}
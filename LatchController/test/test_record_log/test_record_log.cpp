@@ -0,0 +1,144 @@
+/**
+ * @file test_record_log.cpp
+ * @brief Record rotation and recovery on a FileLatchStore (runs on the host)
+ *
+ * pio test -e native
+ */
+
+#include <stdio.h>
+#include <unity.h>
+#include "LatchRecordLog.h"
+
+static const char* PATH = "test_record_log.bin";
+static const uint8_t SLOTS = 4;
+
+// Flips one byte of a slot behind the store's back
+static void corruptSlot(uint8_t slot, size_t recordSize, size_t offset) {
+    FILE* f = fopen(PATH, "r+b");
+    TEST_ASSERT_TRUE(f != nullptr);
+    fseek(f, (long)(slot * recordSize + offset), SEEK_SET);
+    int value = fgetc(f);
+    fseek(f, (long)(slot * recordSize + offset), SEEK_SET);
+    fputc(value ^ 0xFF, f);
+    fclose(f);
+}
+
+void setUp() {
+    remove(PATH);
+}
+
+void tearDown() {
+    remove(PATH);
+}
+
+void test_empty_store_restores_nothing() {
+    FileLatchStore store(PATH, SLOTS);
+    TEST_ASSERT_TRUE(store.begin());
+    LatchRecordLog log(store, 40);
+
+    uint32_t words[2] = { 0xFFFFFFFF, 0xFFFFFFFF };
+    TEST_ASSERT_FALSE(log.restore(words));
+    TEST_ASSERT_EQUAL_HEX32(0, words[0]);
+    TEST_ASSERT_EQUAL_HEX32(0, words[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, log.getNextSlot());
+}
+
+void test_records_rotate_through_slots() {
+    FileLatchStore store(PATH, SLOTS);
+    TEST_ASSERT_TRUE(store.begin());
+    LatchRecordLog log(store, 40);
+    TEST_ASSERT_EQUAL_UINT8(2, log.getWordCount());
+
+    // Two full rounds: every slot written twice, none more often
+    for (uint32_t i = 1; i <= 2 * SLOTS; i++) {
+        TEST_ASSERT_EQUAL_UINT8((i - 1) % SLOTS, log.getNextSlot());
+        uint32_t words[2] = { i, 0x80 | i };
+        TEST_ASSERT_TRUE(log.append(words));
+        TEST_ASSERT_EQUAL_UINT32(i, log.getSequence());
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, log.getNextSlot());
+}
+
+void test_restore_picks_newest_record() {
+    {
+        FileLatchStore store(PATH, SLOTS);
+        TEST_ASSERT_TRUE(store.begin());
+        LatchRecordLog log(store, 40);
+        for (uint32_t i = 1; i <= 6; i++) {
+            uint32_t words[2] = { i, 0x80 | i };
+            TEST_ASSERT_TRUE(log.append(words));
+        }
+    }
+
+    // Slot 1 holds record 6, the older slots 2 and 3 hold 3 and 4
+    FileLatchStore store(PATH, SLOTS);
+    TEST_ASSERT_TRUE(store.begin());
+    LatchRecordLog log(store, 40);
+    uint32_t words[2] = { 0, 0 };
+    TEST_ASSERT_TRUE(log.restore(words));
+    TEST_ASSERT_EQUAL_HEX32(6, words[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x86, words[1]);
+    TEST_ASSERT_EQUAL_UINT32(6, log.getSequence());
+    TEST_ASSERT_EQUAL_UINT8(2, log.getNextSlot());
+
+    // Continues the sequence instead of overwriting the newest record
+    uint32_t next[2] = { 7, 0x87 };
+    TEST_ASSERT_TRUE(log.append(next));
+    TEST_ASSERT_EQUAL_UINT32(7, log.getSequence());
+    TEST_ASSERT_EQUAL_UINT8(3, log.getNextSlot());
+}
+
+void test_corrupt_slot_falls_back_to_previous_record() {
+    size_t recordSize;
+    {
+        FileLatchStore store(PATH, SLOTS);
+        TEST_ASSERT_TRUE(store.begin());
+        LatchRecordLog log(store, 40);
+        recordSize = log.getRecordSize();
+        for (uint32_t i = 1; i <= 3; i++) {
+            uint32_t words[2] = { i, 0x80 | i };
+            TEST_ASSERT_TRUE(log.append(words));
+        }
+    }
+
+    // Torn write of record 3 (slot 2): a state bit no longer matches the CRC
+    corruptSlot(2, recordSize, 13);
+
+    FileLatchStore store(PATH, SLOTS);
+    TEST_ASSERT_TRUE(store.begin());
+    LatchRecordLog log(store, 40);
+    uint32_t words[2] = { 0, 0 };
+    TEST_ASSERT_TRUE(log.restore(words));
+    TEST_ASSERT_EQUAL_HEX32(2, words[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x82, words[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, log.getSequence());
+
+    // The broken slot is the next one written
+    TEST_ASSERT_EQUAL_UINT8(2, log.getNextSlot());
+}
+
+void test_other_channel_count_is_ignored() {
+    {
+        FileLatchStore store(PATH, SLOTS);
+        TEST_ASSERT_TRUE(store.begin());
+        LatchRecordLog log(store, 40);
+        uint32_t words[2] = { 1, 2 };
+        TEST_ASSERT_TRUE(log.append(words));
+    }
+
+    FileLatchStore store(PATH, SLOTS);
+    TEST_ASSERT_TRUE(store.begin());
+    LatchRecordLog log(store, 48);
+    uint32_t words[2] = { 0, 0 };
+    TEST_ASSERT_FALSE(log.restore(words));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_store_restores_nothing);
+    RUN_TEST(test_records_rotate_through_slots);
+    RUN_TEST(test_restore_picks_newest_record);
+    RUN_TEST(test_corrupt_slot_falls_back_to_previous_record);
+    RUN_TEST(test_other_channel_count_is_ignored);
+    return UNITY_END();
+}